@@ -0,0 +1,211 @@
+/**
+ * Бенчмарк CAST-128.
+ *
+ * Проверяет реализацию на контрольных примерах RFC 2144, затем измеряет
+ * время расписания ключей и скорость шифрования/расшифрования блоков
+ * в тактах на байт (по счётчику TSC на x86, иначе только нс/байт) и МБ/с:
+ * поблочно через std::array, на месте по указателю и сообщениями
+ * (с новым результатом на каждый вызов и с буфером вызывающего), а также
+ * режим CTR (ctrCrypt) в одном потоке и на всех ядрах. В конце блочные
+ * функции и CTR сравниваются по реализациям (скалярная, AVX2), доступным
+ * на этом процессоре; результаты реализаций сверяются побайтно. Отдельно
+ * измеряется вывод шифртекста в hex: hexEncode против std::ostringstream.
+ *
+ * Использование: bench_cast128 [размер буфера в КБ, по умолчанию 64] [потоков CTR, 0 - все ядра]
+ */
+
+#include "cast128/cast128.h"
+#include "hex_codec.h"
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define HAVE_TSC 1
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define HAVE_TSC 1
+#endif
+
+using namespace std;
+
+namespace {
+
+inline uint64_t ticks() {
+#ifdef HAVE_TSC
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+struct Measurement {
+    double cyclesPerByte;
+    double nsPerByte;
+};
+
+// Повторяет f над буфером из bytes байт не меньше minSeconds
+template <typename F>
+Measurement measure(size_t bytes, F f, double minSeconds = 0.5) {
+    f();  // прогрев кэшей
+    size_t runs = 0;
+    const uint64_t startTicks = ticks();
+    const auto start = chrono::steady_clock::now();
+    double elapsed = 0;
+    do {
+        f();
+        ++runs;
+        elapsed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    } while (elapsed < minSeconds);
+    const double total = static_cast<double>(bytes) * runs;
+    return {static_cast<double>(ticks() - startTicks) / total, elapsed * 1e9 / total};
+}
+
+void report(const string& name, const Measurement& m) {
+    cout << "  " << name << ": ";
+#ifdef HAVE_TSC
+    cout << m.cyclesPerByte << " такт/байт, ";
+#endif
+    cout << m.nsPerByte << " нс/байт, " << 1e3 / m.nsPerByte << " МБ/с" << endl;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const size_t kilobytes = argc > 1 ? strtoul(argv[1], nullptr, 10) : 64;
+    const size_t size = kilobytes * 1024 / BLOCK_SIZE * BLOCK_SIZE;
+    const unsigned threads = argc > 2 ? static_cast<unsigned>(strtoul(argv[2], nullptr, 10)) : 0;
+
+    if (!cast128SelfTest()) {
+        cerr << "Ошибка: контрольные примеры RFC 2144 не пройдены" << endl;
+        return 1;
+    }
+    cout << "Контрольные примеры RFC 2144: пройдены, реализация "
+         << cast128ImplementationName(cast128Implementation()) << endl;
+
+    cout << fixed << setprecision(2);
+
+    // Расписание ключей
+    size_t schedules = 0;
+    const auto start = chrono::steady_clock::now();
+    double elapsed = 0;
+    uint32_t sink = 0;
+    do {
+        sink ^= generateCastKey("0123456789abcdef").Km[schedules % ROUNDS];
+        ++schedules;
+        elapsed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    } while (elapsed < 0.3);
+    cout << "Расписание ключей: " << elapsed * 1e9 / schedules << " нс" << (sink == 0 ? " " : "") << endl;
+
+    mt19937_64 gen(2025);
+    vector<uint8_t> buffer(size);
+    for (auto& b : buffer) b = static_cast<uint8_t>(gen());
+    string message(buffer.begin(), buffer.end());
+
+    for (const char* password : {"0123456789abcdef", "0123456789"}) {
+        const CastKey key = generateCastKey(password);
+        cout << "Ключ " << strlen(password) * 8 << " бит (" << key.rounds << " раундов), буфер "
+             << kilobytes << " КБ:" << endl;
+
+        report("encryptBlock (копия в std::array)", measure(size, [&] {
+            for (size_t i = 0; i < size; i += BLOCK_SIZE) {
+                array<uint8_t, BLOCK_SIZE> block;
+                memcpy(block.data(), buffer.data() + i, BLOCK_SIZE);
+                encryptBlock(block, key);
+                memcpy(buffer.data() + i, block.data(), BLOCK_SIZE);
+            }
+        }));
+        report("encryptBlocks (на месте)", measure(size, [&] { encryptBlocks(buffer.data(), size, key); }));
+        report("decryptBlocks (на месте)", measure(size, [&] { decryptBlocks(buffer.data(), size, key); }));
+
+        vector<uint8_t> encrypted;
+        report("encryptMessage", measure(size, [&] { encrypted = encryptMessage(message, key); }));
+        string decrypted;
+        report("decryptMessage", measure(size, [&] { decrypted = decryptMessage(encrypted, key); }));
+        if (decrypted != message) {
+            cerr << "Ошибка: расшифрованное сообщение не совпадает с исходным" << endl;
+            return 1;
+        }
+
+        // Буферы результата переиспользуются: после первого вызова без выделений памяти
+        report("encryptMessage (буфер вызывающего)", measure(size, [&] { encryptMessage(message, key, encrypted); }));
+        report("decryptMessage (буфер вызывающего)", measure(size, [&] { decryptMessage(encrypted, key, decrypted); }));
+        if (decrypted != message) {
+            cerr << "Ошибка: расшифрованное сообщение не совпадает с исходным" << endl;
+            return 1;
+        }
+
+        // CTR: блоков CTR_INTERLEAVE за итерацию, затем деление по потокам
+        vector<uint8_t> single(size), parallel(size);
+        report("ctrCrypt (1 поток, блоков за итерацию: " + to_string(CTR_INTERLEAVE) + ")",
+               measure(size, [&] { ctrCrypt(buffer.data(), single.data(), size, key, 2025, 1); }));
+        const unsigned used = threads != 0 ? threads : max(1u, thread::hardware_concurrency());
+        report("ctrCrypt (потоков: " + to_string(used) + ")",
+               measure(size, [&] { ctrCrypt(buffer.data(), parallel.data(), size, key, 2025, threads); }));
+        if (single != parallel) {
+            cerr << "Ошибка: результат CTR зависит от числа потоков" << endl;
+            return 1;
+        }
+        ctrCrypt(parallel.data(), size, key, 2025, threads);
+        if (parallel != buffer) {
+            cerr << "Ошибка: повторное применение CTR не вернуло исходные данные" << endl;
+            return 1;
+        }
+    }
+
+    // Реализации блочных функций: одни и те же данные, один поток
+    const CastKey key = generateCastKey("0123456789abcdef");
+    const Cast128Impl detected = cast128Implementation();
+    vector<uint8_t> reference, ecb(size), ctr(size);
+    for (Cast128Impl impl : {Cast128Impl::Scalar, Cast128Impl::Avx2}) {
+        if (!setCast128Implementation(impl)) {
+            cout << "Реализация " << cast128ImplementationName(impl) << ": не поддерживается процессором" << endl;
+            continue;
+        }
+        cout << "Реализация " << cast128ImplementationName(impl) << ", буфер " << kilobytes << " КБ:" << endl;
+        if (!cast128SelfTest()) {
+            cerr << "Ошибка: контрольные примеры не пройдены" << endl;
+            return 1;
+        }
+        report("encryptBlocks", measure(size, [&] { encryptBlocks(buffer.data(), ecb.data(), size, key); }));
+        report("decryptBlocks", measure(size, [&] { decryptBlocks(ecb.data(), ecb.data(), size, key); }));
+        report("ctrCrypt", measure(size, [&] { ctrCrypt(buffer.data(), ctr.data(), size, key, 2025, 1); }));
+
+        encryptBlocks(buffer.data(), ecb.data(), size, key);
+        vector<uint8_t> result(ecb);
+        result.insert(result.end(), ctr.begin(), ctr.end());
+        if (reference.empty()) reference = result;
+        if (result != reference) {
+            cerr << "Ошибка: результат реализации " << cast128ImplementationName(impl) << " отличается" << endl;
+            return 1;
+        }
+    }
+    setCast128Implementation(detected);
+
+    // Шестнадцатеричный вывод шифртекста
+    cout << "Вывод в hex, буфер " << kilobytes << " КБ:" << endl;
+    string viaStream, viaTable(hexEncodedSize(size), '\0');
+    report("std::ostringstream + setw", measure(size, [&] {
+        ostringstream oss;
+        oss << hex << setfill('0');
+        for (uint8_t byte : ecb) oss << setw(2) << static_cast<int>(byte);
+        viaStream = oss.str();
+    }));
+    report("hexEncode (буфер вызывающего)", measure(size, [&] { hexEncode(ecb.data(), size, &viaTable[0]); }));
+    vector<uint8_t> parsed(size);
+    report("hexDecode", measure(size, [&] { hexDecode(viaTable.data(), viaTable.size(), parsed.data()); }));
+    if (viaStream != viaTable || parsed != ecb) {
+        cerr << "Ошибка: результаты hex-кодирования не совпадают" << endl;
+        return 1;
+    }
+    return 0;
+}
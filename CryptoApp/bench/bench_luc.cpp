@@ -0,0 +1,150 @@
+/**
+ * Бенчмарк LUC: лестница последовательности Люка против прежнего линейного цикла.
+ *
+ * Сравнивает число вычислений V_k(m, 1) mod n в секунду для открытой и закрытой
+ * экспоненты, затем шифрует и расшифровывает файл encryptFileLUC/decryptFileLUC.
+ * Линейный цикл делает k шагов на одно значение, поэтому для закрытой экспоненты
+ * (порядка n) его время только оценивается по измеренной стоимости шага.
+ *
+ * Использование: bench_luc [размер файла в МБ, по умолчанию 10]
+ */
+
+#include "luc/luc.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <string>
+
+using namespace std;
+
+namespace {
+
+// Прежняя реализация lucasSequence: k - 1 шагов рекуррентности
+int64_t lucasSequenceLinear(int64_t k, int64_t P, int64_t Q, int64_t n) {
+    int64_t V_prev = 2 % n;
+    int64_t V_curr = P % n;
+    for (int64_t i = 2; i <= k; ++i) {
+        int64_t V_next = (P * V_curr - Q * V_prev) % n;
+        if (V_next < 0) V_next += n;
+        V_prev = V_curr;
+        V_curr = V_next;
+    }
+    return V_curr;
+}
+
+volatile int64_t sink;
+
+template <typename F>
+double opsPerSecond(F f, double minSeconds = 0.5) {
+    size_t ops = 0;
+    int64_t acc = 0;
+    auto start = chrono::steady_clock::now();
+    double elapsed = 0;
+    do {
+        acc ^= f(static_cast<int64_t>(ops % 256));
+        ++ops;
+        elapsed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    } while (elapsed < minSeconds);
+    sink = acc;
+    return ops / elapsed;
+}
+
+template <typename F>
+double seconds(F f) {
+    auto start = chrono::steady_clock::now();
+    f();
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+bool sameFiles(const string& a, const string& b) {
+    ifstream fa(a, ios::binary), fb(b, ios::binary);
+    return equal(istreambuf_iterator<char>(fa), istreambuf_iterator<char>(),
+                 istreambuf_iterator<char>(fb), istreambuf_iterator<char>());
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const size_t megabytes = argc > 1 ? strtoul(argv[1], nullptr, 10) : 10;
+    const size_t size = megabytes * 1024 * 1024;
+
+    LUCKeys keys = generateLUCKeys();
+    const int64_t e = keys.publicKey, d = keys.privateKey, n = keys.n;
+
+    cout << fixed << setprecision(2);
+    cout << "Ключ: n = " << n << ", e = " << e << ", d = " << d << endl;
+
+    // Одиночные вычисления последовательности
+    const double ladderE = opsPerSecond([&](int64_t m) { return lucasSequence(e, m, 1, n); });
+    const double ladderD = opsPerSecond([&](int64_t m) { return lucasSequence(d, m, 1, n); });
+    const double linearE = opsPerSecond([&](int64_t m) { return lucasSequenceLinear(e, m, 1, n); });
+    const double linearStep = linearE * static_cast<double>(e);  // шагов рекуррентности в секунду
+    const double linearD = linearStep / static_cast<double>(d);
+
+    cout << "V_e (открытый ключ):" << endl;
+    cout << "  линейный цикл: " << linearE << " оп/с" << endl;
+    cout << "  лестница: " << ladderE << " оп/с (ускорение x" << ladderE / linearE << ")" << endl;
+    cout << "V_d (закрытый ключ):" << endl;
+    cout << "  линейный цикл (оценка): " << scientific << linearD << fixed << " оп/с" << endl;
+    cout << "  лестница: " << ladderD << " оп/с (ускорение x" << scientific << ladderD / linearD
+         << fixed << ")" << endl;
+
+    // Файл случайных байт
+    const auto dir = filesystem::temp_directory_path();
+    const string plainFile = (dir / "bench_luc.plain").string();
+    const string cipherFile = (dir / "bench_luc.enc").string();
+    const string decryptedFile = (dir / "bench_luc.dec").string();
+    // Кодовая книга каждого потока расшифрования вычисляет V_d один раз на
+    // значение байта, встреченное в файле
+    size_t distinctBytes = 0;
+    {
+        mt19937_64 gen(2025);
+        string data(size, '\0');
+        bool seen[256] = {};
+        for (auto& c : data) {
+            c = static_cast<char>(gen());
+            if (!seen[static_cast<uint8_t>(c)]) {
+                seen[static_cast<uint8_t>(c)] = true;
+                ++distinctBytes;
+            }
+        }
+        ofstream(plainFile, ios::binary).write(data.data(), static_cast<streamsize>(data.size()));
+    }
+
+    LUCKeyContext encryptor(LUCKeys{e, 0, n});
+    LUCKeyContext decryptor(LUCKeys{0, d, n});
+    const double encSeconds = seconds([&] { encryptFileLUC(plainFile, cipherFile, encryptor); });
+    const double decSeconds = seconds([&] { decryptFileLUC(cipherFile, decryptedFile, decryptor); });
+    if (!sameFiles(plainFile, decryptedFile)) {
+        cerr << "Ошибка: расшифрованный файл не совпадает с исходным" << endl;
+        return 1;
+    }
+
+    // Вычисления последовательности приходятся только на промахи кодовой книги:
+    // прогрев шифрования (в encryptor) и первые встречи байт при расшифровании
+    const auto encStats = encryptor.codebookStats();
+    const double decMisses = static_cast<double>(distinctBytes);
+    const double mb = static_cast<double>(size) / 1e6;
+    cout << "Файл " << megabytes << " МБ:" << endl;
+    cout << "  encryptFileLUC: " << encSeconds << " с, " << mb / encSeconds << " МБ/с (промахов "
+         << encStats.misses << ")" << endl;
+    cout << "  decryptFileLUC: " << decSeconds << " с, " << mb / decSeconds << " МБ/с (промахов "
+         << distinctBytes << " на поток)" << endl;
+    cout << "  последовательности Люка, лестница: "
+         << (256 / ladderE + decMisses / ladderD) * 1000 << " мс" << endl;
+    cout << "  последовательности Люка, линейный цикл (оценка): "
+         << 256 / linearE + decMisses / linearD << " с" << endl;
+
+    remove(plainFile.c_str());
+    remove(cipherFile.c_str());
+    remove(decryptedFile.c_str());
+    return 0;
+}
@@ -0,0 +1,79 @@
+/**
+ * Микробенчмарк модульного возведения в степень.
+ *
+ * Сравнивает прежний линейный цикл (e умножений на символ) с движком modexp:
+ * square-and-multiply, скользящим окном и умножением Монтгомери.
+ * Результат - число операций возведения в степень в секунду.
+ */
+
+#include "rsa/modexp.h"
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+namespace {
+
+// Прежняя реализация из encryptMessageRSA/decryptMessageRSA
+uint64_t powmodLinear(uint64_t base, uint64_t exp, uint64_t mod) {
+    uint64_t result = 1;
+    for (uint64_t i = 0; i < exp; ++i) {
+        result = (result * base) % mod;
+    }
+    return result;
+}
+
+volatile uint64_t sink;
+
+template <typename F>
+void run(const string& name, const vector<uint64_t>& bases, F f) {
+    const auto deadline = chrono::milliseconds(300);
+    size_t ops = 0;
+    uint64_t acc = 0;
+    auto start = chrono::steady_clock::now();
+    auto now = start;
+    do {
+        for (uint64_t b : bases) acc ^= f(b);
+        ops += bases.size();
+        now = chrono::steady_clock::now();
+    } while (now - start < deadline);
+    sink = acc;
+
+    double seconds = chrono::duration<double>(now - start).count();
+    cout << "  " << name << ": " << fixed << setprecision(0) << ops / seconds << " оп/с" << endl;
+}
+
+void benchKey(const string& title, uint64_t exp, uint64_t mod, bool withLinear) {
+    mt19937_64 gen(42);
+    uniform_int_distribution<uint64_t> dist(2, mod - 1);
+    vector<uint64_t> bases(256);
+    for (auto& b : bases) b = dist(gen);
+
+    cout << title << " (n = " << mod << ", показатель = " << exp << ")" << endl;
+    if (withLinear) {
+        run("линейный цикл", bases, [&](uint64_t b) { return powmodLinear(b, exp, mod); });
+    }
+    run("square-and-multiply", bases, [&](uint64_t b) { return powmodBinary(b, exp, mod); });
+    run("скользящее окно", bases, [&](uint64_t b) { return powmodWindow(b, exp, mod); });
+    Montgomery64 mont(mod);
+    run("Монтгомери", bases, [&](uint64_t b) { return mont.pow(b, exp); });
+    cout << endl;
+}
+
+} // namespace
+
+int main() {
+    // Учебный ключ generateRSAKeys(): p = 61, q = 53, d = 2753
+    benchKey("Учебный ключ", 2753, 3233, true);
+
+    // 62-битный модуль с полноразмерным показателем: линейный цикл здесь неприменим
+    const uint64_t p = 2147483647ULL;  // 2^31 - 1
+    const uint64_t q = 2147483629ULL;
+    benchKey("62-битный модуль", 0x2f1e3d4c5b6a7981ULL, p * q, false);
+    return 0;
+}
@@ -0,0 +1,102 @@
+/**
+ * Бенчмарк многопоточного шифрования файлов RSA и LUC.
+ *
+ * Файл случайных байт шифруется и расшифровывается encryptFileRSA/decryptFileRSA
+ * (блоки по 7 байт, CRT) и encryptFileLUC/decryptFileLUC (кодовая книга) при
+ * 1, 2, 4, ... потоках до числа ядер. Для каждого числа потоков выводится МБ/с
+ * и проверяется, что шифртекст совпадает с однопоточным побайтно.
+ *
+ * Использование: bench_pipeline [размер файла в МБ, по умолчанию 16] [максимум потоков]
+ */
+
+#include "luc/luc.h"
+#include "rsa/rsa.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+namespace {
+
+template <typename F>
+double seconds(F f) {
+    auto start = chrono::steady_clock::now();
+    f();
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+string readFile(const string& name) {
+    ifstream in(name, ios::binary);
+    return string(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const size_t megabytes = argc > 1 ? strtoul(argv[1], nullptr, 10) : 16;
+    const unsigned hw = thread::hardware_concurrency() != 0 ? thread::hardware_concurrency() : 1;
+    const unsigned maxThreads = argc > 2 ? static_cast<unsigned>(strtoul(argv[2], nullptr, 10)) : hw;
+
+    vector<unsigned> counts;
+    for (unsigned t = 1; t < maxThreads; t *= 2) counts.push_back(t);
+    counts.push_back(maxThreads);
+
+    const auto dir = filesystem::temp_directory_path();
+    const string plainFile = (dir / "bench_pipeline.plain").string();
+    const string cipherFile = (dir / "bench_pipeline.enc").string();
+    const string decryptedFile = (dir / "bench_pipeline.dec").string();
+
+    const size_t size = megabytes * 1024 * 1024;
+    string plain(size, '\0');
+    {
+        mt19937_64 gen(2025);
+        for (auto& c : plain) c = static_cast<char>(gen());
+        ofstream(plainFile, ios::binary).write(plain.data(), static_cast<streamsize>(plain.size()));
+    }
+
+    RSAKeys rsa = generateRSAKeys();
+    LUCKeys luc = generateLUCKeys();
+    const double mb = static_cast<double>(size) / 1e6;
+
+    cout << fixed << setprecision(2);
+    cout << "Файл " << megabytes << " МБ, ядер: " << hw << endl;
+
+    string rsaReference, lucReference;
+    for (unsigned threads : counts) {
+        const double rsaEnc = seconds([&] { encryptFileRSA(plainFile, cipherFile, rsa.publicKey, rsa.n, threads); });
+        const string rsaCipher = readFile(cipherFile);
+        const double rsaDec = seconds([&] { decryptFileRSA(cipherFile, decryptedFile, rsa, threads); });
+        const bool rsaOk = readFile(decryptedFile) == plain;
+
+        const double lucEnc = seconds([&] { encryptFileLUC(plainFile, cipherFile, luc.publicKey, luc.n, threads); });
+        const string lucCipher = readFile(cipherFile);
+        const double lucDec = seconds([&] { decryptFileLUC(cipherFile, decryptedFile, luc.privateKey, luc.n, threads); });
+        const bool lucOk = readFile(decryptedFile) == plain;
+
+        if (rsaReference.empty()) rsaReference = rsaCipher;
+        if (lucReference.empty()) lucReference = lucCipher;
+        if (!rsaOk || !lucOk || rsaCipher != rsaReference || lucCipher != lucReference) {
+            cerr << "Ошибка: результат при " << threads << " потоках отличается от ожидаемого" << endl;
+            return 1;
+        }
+
+        cout << "Потоков " << threads << ":" << endl;
+        cout << "  RSA: шифрование " << mb / rsaEnc << " МБ/с, расшифрование " << mb / rsaDec << " МБ/с" << endl;
+        cout << "  LUC: шифрование " << mb / lucEnc << " МБ/с, расшифрование " << mb / lucDec << " МБ/с" << endl;
+    }
+
+    remove(plainFile.c_str());
+    remove(cipherFile.c_str());
+    remove(decryptedFile.c_str());
+    return 0;
+}
@@ -0,0 +1,112 @@
+/**
+ * Микробенчмарк проверки простоты 64-битных чисел.
+ *
+ * Сравнивает прежний isPrime из luc.cpp/rsa_crypto.cpp (5 случайных оснований,
+ * новый random_device/mt19937_64 на каждый вызов) с детерминированным
+ * Миллером-Рабином из common/primality.h: по одному числу и пакетно.
+ * Наборы: нечётные кандидаты (как при генерации ключа) и только простые
+ * (все семь оснований проходят до конца). Результат - чисел в секунду.
+ */
+
+#include "primality.h"
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+namespace {
+
+// Прежняя реализация (без переполнения: умножение через mulMod64)
+bool isPrimeRandom(uint64_t n, int k = 5) {
+    if (n <= 1 || n == 4) return false;
+    if (n <= 3) return true;
+
+    uint64_t d = n - 1;
+    while (d % 2 == 0) d /= 2;
+
+    random_device rd;
+    mt19937_64 gen(rd());
+    uniform_int_distribution<uint64_t> dist(2, n - 2);
+    for (int i = 0; i < k; i++) {
+        uint64_t x = powMod64(dist(gen), d, n);
+        if (x == 1 || x == n - 1) continue;
+        uint64_t t = d;
+        while (t != n - 1) {
+            x = mulMod64(x, x, n);
+            t *= 2;
+            if (x == 1) return false;
+            if (x == n - 1) break;
+        }
+        if (x != n - 1) return false;
+    }
+    return true;
+}
+
+volatile size_t sink;
+
+template <typename F>
+void run(const string& name, const vector<uint64_t>& numbers, F f) {
+    const auto deadline = chrono::milliseconds(300);
+    size_t ops = 0;
+    size_t primes = 0;
+    auto start = chrono::steady_clock::now();
+    auto now = start;
+    do {
+        primes = f(numbers);
+        ops += numbers.size();
+        now = chrono::steady_clock::now();
+    } while (now - start < deadline);
+    sink = primes;
+
+    double seconds = chrono::duration<double>(now - start).count();
+    cout << "  " << name << ": " << fixed << setprecision(0) << ops / seconds << " чисел/с (простых "
+         << primes << " из " << numbers.size() << ")" << endl;
+}
+
+void benchSet(const string& title, const vector<uint64_t>& numbers) {
+    cout << title << endl;
+    run("случайные основания (прежний)", numbers, [](const vector<uint64_t>& v) {
+        size_t count = 0;
+        for (uint64_t n : v) count += isPrimeRandom(n);
+        return count;
+    });
+    run("isPrime64", numbers, [](const vector<uint64_t>& v) {
+        size_t count = 0;
+        for (uint64_t n : v) count += isPrime64(n);
+        return count;
+    });
+    unique_ptr<bool[]> flags(new bool[numbers.size()]);
+    run("isPrime64Batch", numbers, [&](const vector<uint64_t>& v) {
+        isPrime64Batch(v.data(), v.size(), flags.get());
+        size_t count = 0;
+        for (size_t i = 0; i < v.size(); ++i) count += flags[i];
+        return count;
+    });
+    cout << endl;
+}
+
+} // namespace
+
+int main() {
+    mt19937_64 gen(42);
+    for (int bits : {31, 62}) {
+        vector<uint64_t> candidates(4096);
+        for (auto& n : candidates) n = (gen() >> (64 - bits)) | (uint64_t{1} << (bits - 1)) | 1;
+
+        vector<uint64_t> primes;
+        while (primes.size() < 1024) {
+            const uint64_t n = (gen() >> (64 - bits)) | (uint64_t{1} << (bits - 1)) | 1;
+            if (isPrime64(n)) primes.push_back(n);
+        }
+
+        benchSet(to_string(bits) + " бит, нечётные кандидаты:", candidates);
+        benchSet(to_string(bits) + " бит, только простые:", primes);
+    }
+    return 0;
+}
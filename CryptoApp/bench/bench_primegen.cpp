@@ -0,0 +1,138 @@
+/**
+ * Бенчмарк генерации простых чисел для ключей.
+ *
+ * Сравнивает прежний перебор (случайный кандидат - полный тест, для учебных
+ * ключей ещё и новый random_device/mt19937_64 на каждый вызов) с
+ * инкрементным решетом common/prime_sieve.h:
+ *  - p, q из [1000, 10000] (rsa_crypto.cpp, luc.cpp);
+ *  - 31-битные p, q (generateRSAKeys в CryptoApp);
+ *  - простые половинной длины для RSA-2048 и RSA-3072 (generateBigPrime).
+ * Результат - среднее время на одно простое.
+ *
+ * Использование: bench_primegen [число простых для BigInt, по умолчанию 8]
+ */
+
+#include "rsa/rsa.h"
+#include "rsa/bignum.h"
+#include "prime_sieve.h"
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+
+using namespace std;
+
+namespace {
+
+// Прежний isPrime из rsa_crypto.cpp/luc.cpp: 5 случайных оснований,
+// генератор создаётся заново на каждую проверку
+bool isPrimeRandom(int64_t n, int k = 5) {
+    if (n <= 1 || n == 4) return false;
+    if (n <= 3) return true;
+    int64_t d = n - 1;
+    while (d % 2 == 0) d /= 2;
+    random_device rd;
+    mt19937_64 gen(rd());
+    uniform_int_distribution<int64_t> dist(2, n - 2);
+    for (int i = 0; i < k; i++) {
+        const uint64_t un = static_cast<uint64_t>(n);
+        uint64_t x = powMod64(static_cast<uint64_t>(dist(gen)), static_cast<uint64_t>(d), un);
+        if (x == 1 || x == un - 1) continue;
+        int64_t t = d;
+        while (t != n - 1) {
+            x = mulMod64(x, x, un);
+            t *= 2;
+            if (x == 1) return false;
+            if (x == un - 1) break;
+        }
+        if (x != un - 1) return false;
+    }
+    return true;
+}
+
+// Прежний generatePrime из rsa_crypto.cpp/luc.cpp
+int64_t generatePrimeOld(int64_t min, int64_t max) {
+    random_device rd;
+    mt19937_64 gen(rd());
+    uniform_int_distribution<int64_t> dist(min, max);
+    int64_t num;
+    do {
+        num = dist(gen);
+        if (num % 2 == 0 && num != 2) num++;
+    } while (!isPrimeRandom(num));
+    return num;
+}
+
+// Прежний generatePrime64 из rsa.cpp
+uint64_t generatePrime64Old(mt19937_64& gen, uint64_t min, uint64_t max) {
+    uniform_int_distribution<uint64_t> dist(min, max);
+    uint64_t num;
+    do {
+        num = dist(gen) | 1;
+    } while (!isPrime64(num));
+    return num;
+}
+
+// Прежний generateBigPrime: каждый кандидат - пробное деление и Миллер-Рабин
+BigInt generateBigPrimeOld(unsigned bits, mt19937_64& gen) {
+    const BigInt e(65537);
+    while (true) {
+        BigInt candidate = BigInt::random(bits, gen);
+        if (!candidate.testBit(bits - 2)) candidate = candidate + (BigInt(1) << (bits - 2));
+        if (!candidate.isOdd()) candidate = candidate + BigInt(1);
+        if (candidate.bitLength() != bits) continue;
+        if (!isProbablePrime(candidate, gen, 8)) continue;
+        if (gcd(candidate - BigInt(1), e) != BigInt(1)) continue;
+        return candidate;
+    }
+}
+
+volatile uint64_t sink;
+
+// Среднее время одного вызова f в микросекундах (не меньше runs вызовов и 0.3 с)
+template <typename F>
+double averageMicros(F f, int runs) {
+    int done = 0;
+    uint64_t acc = 0;
+    const auto start = chrono::steady_clock::now();
+    double elapsed = 0;
+    do {
+        acc ^= f();
+        ++done;
+        elapsed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    } while (done < runs || elapsed < 0.3);
+    sink = acc;
+    return elapsed * 1e6 / done;
+}
+
+void report(const string& title, double before, double after) {
+    cout << title << endl;
+    cout << "  перебор:  " << setw(12) << before << " мкс" << endl;
+    cout << "  решето:   " << setw(12) << after << " мкс (ускорение x" << before / after << ")" << endl;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const int bigRuns = argc > 1 ? max(1, atoi(argv[1])) : 8;
+    mt19937_64 gen(2025);
+    cout << fixed << setprecision(2);
+
+    report("Учебные p, q из [1000, 10000]:",
+           averageMicros([] { return static_cast<uint64_t>(generatePrimeOld(1000, 10000)); }, 1000),
+           averageMicros([&] { return randomPrime64(gen, 1000, 10000); }, 1000));
+
+    const uint64_t lo = uint64_t{1} << 30, hi = (uint64_t{1} << 31) - 1;
+    report("31-битные p, q (generateRSAKeys):",
+           averageMicros([&] { return generatePrime64Old(gen, lo, hi); }, 1000),
+           averageMicros([&] { return randomPrime64(gen, lo, hi); }, 1000));
+
+    for (unsigned bits : {1024u, 1536u}) {
+        report("Простое из " + to_string(bits) + " бит (RSA-" + to_string(2 * bits) + "):",
+               averageMicros([&] { return generateBigPrimeOld(bits, gen).toUint64(); }, bigRuns),
+               averageMicros([&] { return generateBigPrime(bits, gen).toUint64(); }, bigRuns));
+    }
+    return 0;
+}
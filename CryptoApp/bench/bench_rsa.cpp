@@ -0,0 +1,108 @@
+/**
+ * Бенчмарк RSA произвольной длины.
+ *
+ * Для ключей 2048, 3072 и 4096 бит измеряет время генерации ключа,
+ * а также число операций в секунду с открытым ключом (шифрование/проверка)
+ * и с закрытым ключом (расшифрование/подпись) с CRT и без него.
+ * Для учебного 62-битного ключа сравнивается блочное расшифрование сообщения
+ * с CRT и без него, а также побайтовое расшифрование с кодовой книгой (RSAKeyContext).
+ *
+ * Использование: bench_rsa [число генераций ключа на размер, по умолчанию 2]
+ */
+
+#include "rsa/rsa.h"
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+namespace {
+
+template <typename F>
+double opsPerSecond(F f, double minSeconds = 1.0) {
+    size_t ops = 0;
+    auto start = chrono::steady_clock::now();
+    double elapsed = 0;
+    do {
+        f();
+        ++ops;
+        elapsed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    } while (elapsed < minSeconds);
+    return ops / elapsed;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const int keygenRuns = argc > 1 ? atoi(argv[1]) : 2;
+    const unsigned sizes[] = {2048, 3072, 4096};
+    mt19937_64 gen(2025);
+
+    cout << fixed << setprecision(2);
+    for (unsigned bits : sizes) {
+        RSABigKeys keys;
+        double keygenTotal = 0;
+        for (int i = 0; i < keygenRuns; ++i) {
+            auto start = chrono::steady_clock::now();
+            keys = generateRSABigKeys(bits);
+            keygenTotal += chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        }
+
+        BigInt message = BigInt::randomBelow(keys.n, gen);
+        BigInt cipher = encryptRSA(message, keys);
+        if (decryptRSA(cipher, keys) != message) {
+            cerr << "Ошибка: расшифрованное сообщение не совпадает с исходным" << endl;
+            return 1;
+        }
+
+        double pubOps = opsPerSecond([&] { cipher = encryptRSA(message, keys); });
+        double plainOps = opsPerSecond([&] { message = decryptRSA(cipher, keys, false); });
+        double crtOps = opsPerSecond([&] { message = decryptRSA(cipher, keys); });
+
+        cout << "RSA-" << bits << ":" << endl;
+        cout << "  генерация ключа: " << keygenTotal / keygenRuns * 1000 << " мс (среднее по "
+             << keygenRuns << ")" << endl;
+        cout << "  открытый ключ (шифрование/проверка): " << pubOps << " оп/с" << endl;
+        cout << "  закрытый ключ без CRT: " << plainOps << " оп/с" << endl;
+        cout << "  закрытый ключ с CRT: " << crtOps << " оп/с (ускорение x"
+             << crtOps / plainOps << ")" << endl;
+    }
+
+    // Пакетное (блочное) расшифрование учебным ключом: 64 КБ текста
+    RSAKeys small = generateRSAKeys();
+    string text(64 * 1024, '\0');
+    for (auto& c : text) c = static_cast<char>('a' + gen() % 26);
+    vector<int64_t> blocks = encryptMessageRSABlocks(text, small.publicKey, small.n);
+    if (decryptMessageRSABlocks(blocks, small) != text) {
+        cerr << "Ошибка: CRT-расшифрование не совпадает с исходным текстом" << endl;
+        return 1;
+    }
+    string out;
+    double plainBytes = opsPerSecond([&] { out = decryptMessageRSABlocks(blocks, small.privateKey, small.n); }) * text.size();
+    double crtBytes = opsPerSecond([&] { out = decryptMessageRSABlocks(blocks, small); }) * text.size();
+    cout << "RSA-62 (пакетное расшифрование):" << endl;
+    cout << "  без CRT: " << plainBytes / 1e6 << " МБ/с" << endl;
+    cout << "  с CRT: " << crtBytes / 1e6 << " МБ/с (ускорение x" << crtBytes / plainBytes << ")" << endl;
+
+    // Побайтовый режим: кодовая книга строится заново для каждого сообщения
+    // или одна на все сообщения ключа
+    vector<int64_t> words = encryptMessageRSA(text, small.publicKey, small.n);
+    double coldBytes = opsPerSecond([&] { out = decryptMessageRSA(words, small); }) * text.size();
+    RSAKeyContext ctx(small);
+    double warmBytes = opsPerSecond([&] { out = ctx.decryptMessage(words); }) * text.size();
+    if (out != text) {
+        cerr << "Ошибка: побайтовое расшифрование не совпадает с исходным текстом" << endl;
+        return 1;
+    }
+    ByteCodebook::Stats stats = ctx.codebookStats();
+    cout << "RSA-62 (побайтовое расшифрование):" << endl;
+    cout << "  кодовая книга на сообщение: " << coldBytes / 1e6 << " МБ/с" << endl;
+    cout << "  кодовая книга на ключ: " << warmBytes / 1e6 << " МБ/с, попаданий " << stats.hits
+         << ", промахов " << stats.misses << endl;
+    return 0;
+}
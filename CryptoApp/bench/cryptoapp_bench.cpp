@@ -0,0 +1,345 @@
+/**
+ * Сводный бенчмарк CryptoApp: генерация ключа, шифрование и расшифрование
+ * CAST-128, RSA и LUC.
+ *
+ * Шифрование идёт через общий драйвер stream_cipher.h (тот же путь, что и
+ * пакетный режим CryptoApp) над потоками в памяти, для каждого размера
+ * сообщения и числа потоков. Каждая операция повторяется --reps раз после
+ * прогрева; по выборке выводятся задержки p50/p90/p99, минимум и максимум,
+ * а МБ/с считаются по медиане. Генерация ключа измеряется без сообщения.
+ *
+ * Результаты пишутся в CSV (--csv) и JSON (--json), "-" - в stdout.
+ * С --baseline ФАЙЛ.csv (ранее записанный --csv) медианы сравниваются с
+ * базовыми: замедление больше --tolerance процентов считается регрессией,
+ * и программа завершается с кодом 2. Ошибки - код 1.
+ *
+ * Использование: cryptoapp_bench [--alg cast128,rsa,luc] [--sizes 4096,262144,4194304]
+ *                                [--threads 1,4] [--reps N] [--csv ФАЙЛ|-] [--json ФАЙЛ|-]
+ *                                [--baseline ФАЙЛ.csv] [--tolerance ПРОЦЕНТ]
+ */
+
+#include "cast128/cast128.h"
+#include "luc/luc.h"
+#include "rsa/rsa.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+using namespace std;
+
+namespace {
+
+struct Result {
+    string alg;
+    string op;
+    size_t size;     // 0 для генерации ключа
+    unsigned threads;
+    size_t reps;
+    double p50;      // задержки в микросекундах
+    double p90;
+    double p99;
+    double min;
+    double max;
+    double mbPerSecond;  // по медиане; 0 для генерации ключа
+};
+
+// Ключ сравнения с базовыми результатами
+using ResultKey = tuple<string, string, size_t, unsigned>;
+
+ResultKey keyOf(const Result& r) {
+    return ResultKey(r.alg, r.op, r.size, r.threads);
+}
+
+// Процентиль по отсортированной выборке (ближайший ранг)
+double percentile(const vector<double>& sorted, double p) {
+    const size_t rank = static_cast<size_t>(p / 100.0 * static_cast<double>(sorted.size()) + 0.999999);
+    return sorted[min(sorted.size(), max<size_t>(rank, 1)) - 1];
+}
+
+Result measure(const string& alg, const string& op, size_t size, unsigned threads, size_t reps,
+               const function<void()>& f) {
+    f();  // прогрев: кодовые книги, страницы буферов, потоки ОС
+    vector<double> samples;
+    samples.reserve(reps);
+    for (size_t i = 0; i < reps; ++i) {
+        const auto start = chrono::steady_clock::now();
+        f();
+        samples.push_back(chrono::duration<double, micro>(chrono::steady_clock::now() - start).count());
+    }
+    sort(samples.begin(), samples.end());
+    Result r{alg, op, size, threads, reps,
+             percentile(samples, 50), percentile(samples, 90), percentile(samples, 99),
+             samples.front(), samples.back(), 0};
+    if (size > 0 && r.p50 > 0) r.mbPerSecond = static_cast<double>(size) / r.p50;
+    return r;
+}
+
+vector<string> splitList(const string& text) {
+    vector<string> items;
+    stringstream in(text);
+    string item;
+    while (getline(in, item, ',')) {
+        if (!item.empty()) items.push_back(item);
+    }
+    return items;
+}
+
+vector<size_t> parseNumbers(const string& text, const string& option) {
+    vector<size_t> numbers;
+    for (const string& item : splitList(text)) {
+        char* end = nullptr;
+        const unsigned long long value = strtoull(item.c_str(), &end, 10);
+        if (*end != '\0' || value == 0) {
+            throw invalid_argument("Некорректное значение " + option + ": " + item);
+        }
+        numbers.push_back(static_cast<size_t>(value));
+    }
+    if (numbers.empty()) {
+        throw invalid_argument("Пустой список " + option);
+    }
+    return numbers;
+}
+
+string sizeLabel(size_t size) {
+    if (size == 0) return "-";
+    if (size >= (size_t{1} << 20) && size % (size_t{1} << 20) == 0) return to_string(size >> 20) + " МБ";
+    if (size >= (size_t{1} << 10) && size % (size_t{1} << 10) == 0) return to_string(size >> 10) + " КБ";
+    return to_string(size) + " Б";
+}
+
+void printRow(ostream& out, const Result& r) {
+    out << "  " << left << setw(8) << r.alg << setw(8) << r.op << right << setw(8) << sizeLabel(r.size)
+        << setw(3) << r.threads << " пот. " << fixed << setprecision(1)
+        << "p50 " << setw(10) << r.p50 << " мкс  p90 " << setw(10) << r.p90 << " мкс  p99 " << setw(10) << r.p99
+        << " мкс  ";
+    if (r.size > 0) out << setw(8) << r.mbPerSecond << " МБ/с";
+    out << "\n";
+}
+
+const char* CSV_HEADER = "alg,op,size,threads,reps,p50_us,p90_us,p99_us,min_us,max_us,mb_per_s";
+
+void writeCsv(ostream& out, const vector<Result>& results) {
+    out << CSV_HEADER << "\n" << setprecision(6) << defaultfloat;
+    for (const Result& r : results) {
+        out << r.alg << ',' << r.op << ',' << r.size << ',' << r.threads << ',' << r.reps << ',' << r.p50 << ','
+            << r.p90 << ',' << r.p99 << ',' << r.min << ',' << r.max << ',' << r.mbPerSecond << "\n";
+    }
+}
+
+void writeJson(ostream& out, const vector<Result>& results) {
+    out << "{\n  \"benchmark\": \"cryptoapp\",\n  \"hardware_threads\": " << thread::hardware_concurrency()
+        << ",\n  \"results\": [\n" << setprecision(6) << defaultfloat;
+    for (size_t i = 0; i < results.size(); ++i) {
+        const Result& r = results[i];
+        out << "    {\"alg\": \"" << r.alg << "\", \"op\": \"" << r.op << "\", \"size\": " << r.size
+            << ", \"threads\": " << r.threads << ", \"reps\": " << r.reps << ", \"p50_us\": " << r.p50
+            << ", \"p90_us\": " << r.p90 << ", \"p99_us\": " << r.p99 << ", \"min_us\": " << r.min
+            << ", \"max_us\": " << r.max << ", \"mb_per_s\": " << r.mbPerSecond << "}"
+            << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n}\n";
+}
+
+void writeOutput(const string& path, const function<void(ostream&)>& write) {
+    if (path == "-") {
+        write(cout);
+        return;
+    }
+    ofstream file(path);
+    write(file);
+    if (!file) {
+        throw runtime_error("Ошибка записи " + path);
+    }
+}
+
+// Медианы p50 из CSV, записанного writeCsv
+map<ResultKey, double> readBaseline(const string& path) {
+    ifstream in(path);
+    if (!in) {
+        throw runtime_error("Не удалось открыть базовые результаты: " + path);
+    }
+    string line;
+    if (!getline(in, line) || line != CSV_HEADER) {
+        throw runtime_error("Файл не является CSV cryptoapp_bench: " + path);
+    }
+    map<ResultKey, double> baseline;
+    while (getline(in, line)) {
+        if (line.empty()) continue;
+        vector<string> fields;
+        stringstream row(line);
+        string field;
+        while (getline(row, field, ',')) fields.push_back(field);
+        if (fields.size() != 11) {
+            throw runtime_error("Некорректная строка базовых результатов: " + line);
+        }
+        baseline[ResultKey(fields[0], fields[1], strtoull(fields[2].c_str(), nullptr, 10),
+                           static_cast<unsigned>(strtoul(fields[3].c_str(), nullptr, 10)))] =
+            strtod(fields[5].c_str(), nullptr);
+    }
+    return baseline;
+}
+
+// Печатает сравнение и возвращает число регрессий
+size_t compareWithBaseline(ostream& out, const vector<Result>& results, const map<ResultKey, double>& baseline,
+                           double tolerance) {
+    size_t regressions = 0;
+    out << "Сравнение с базовыми результатами (порог " << fixed << setprecision(1) << tolerance << "%):\n";
+    for (const Result& r : results) {
+        const auto it = baseline.find(keyOf(r));
+        if (it == baseline.end() || it->second <= 0) continue;
+        const double change = (r.p50 / it->second - 1.0) * 100.0;
+        const bool regression = change > tolerance;
+        regressions += regression ? 1 : 0;
+        out << "  " << left << setw(8) << r.alg << setw(8) << r.op << right << setw(8) << sizeLabel(r.size)
+            << setw(3) << r.threads << " пот. " << setw(10) << it->second << " -> " << setw(10) << r.p50
+            << " мкс " << showpos << setw(7) << change << noshowpos << "%" << (regression ? "  РЕГРЕССИЯ" : "")
+            << "\n";
+    }
+    return regressions;
+}
+
+// Шифр вместе с функцией генерации ключа для замера keygen
+struct Algorithm {
+    string name;
+    function<void()> keygen;
+    unique_ptr<StreamCipher> cipher;
+};
+
+Algorithm makeAlgorithm(const string& name) {
+    if (name == "cast128") {
+        return {name, [] { generateCastKey("benchmark-key"); },
+                makeCast128StreamCipher(generateCastKey("benchmark-key"))};
+    }
+    if (name == "rsa") {
+        return {name, [] { generateRSAKeys(); }, makeRSAStreamCipher(generateRSAKeys())};
+    }
+    if (name == "luc") {
+        return {name, [] { generateLUCKeys(); }, makeLUCStreamCipher(LUCKeyContext(generateLUCKeys()))};
+    }
+    throw invalid_argument("Неизвестный алгоритм: " + name);
+}
+
+void rewind(istringstream& in, ostringstream& out) {
+    in.clear();
+    in.seekg(0);
+    out.str(string());
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    vector<string> algorithms = {"cast128", "rsa", "luc"};
+    vector<size_t> sizes = {4096, 262144, 4194304};
+    const unsigned hw = thread::hardware_concurrency() != 0 ? thread::hardware_concurrency() : 1;
+    vector<size_t> threadCounts = {1};
+    if (hw > 1) threadCounts.push_back(hw);
+    size_t reps = 15;
+    string csvPath, jsonPath, baselinePath;
+    double tolerance = 10.0;
+
+    try {
+        for (int i = 1; i < argc; ++i) {
+            const string arg = argv[i];
+            if (i + 1 >= argc) {
+                throw invalid_argument("Не указано значение для " + arg);
+            }
+            const string value = argv[++i];
+            if (arg == "--alg") algorithms = splitList(value);
+            else if (arg == "--sizes") sizes = parseNumbers(value, arg);
+            else if (arg == "--threads") threadCounts = parseNumbers(value, arg);
+            else if (arg == "--reps") reps = parseNumbers(value, arg).front();
+            else if (arg == "--csv") csvPath = value;
+            else if (arg == "--json") jsonPath = value;
+            else if (arg == "--baseline") baselinePath = value;
+            else if (arg == "--tolerance") tolerance = strtod(value.c_str(), nullptr);
+            else throw invalid_argument("Неизвестный параметр: " + arg);
+        }
+        if (csvPath == "-" && jsonPath == "-") {
+            throw invalid_argument("В stdout можно вывести только один из --csv и --json");
+        }
+    } catch (const exception& e) {
+        cerr << e.what() << "\n"
+             << "Использование: " << argv[0]
+             << " [--alg cast128,rsa,luc] [--sizes БАЙТ,...] [--threads N,...] [--reps N]"
+                " [--csv ФАЙЛ|-] [--json ФАЙЛ|-] [--baseline ФАЙЛ.csv] [--tolerance ПРОЦЕНТ]\n";
+        return 1;
+    }
+
+    // При выводе CSV/JSON в stdout таблица уходит в stderr
+    ostream& table = csvPath == "-" || jsonPath == "-" ? cerr : cout;
+    vector<Result> results;
+    try {
+        // Базовый файл проверяется до замеров, а не после
+        map<ResultKey, double> baseline;
+        if (!baselinePath.empty()) baseline = readBaseline(baselinePath);
+
+        table << "Ядер: " << hw << ", повторов: " << reps << "\n";
+        mt19937_64 gen(2025);
+        for (const string& name : algorithms) {
+            Algorithm alg = makeAlgorithm(name);
+            table << alg.name << ":\n";
+
+            results.push_back(measure(alg.name, "keygen", 0, 1, reps, alg.keygen));
+            printRow(table, results.back());
+
+            for (size_t size : sizes) {
+                string plain(size, '\0');
+                for (auto& c : plain) c = static_cast<char>(gen());
+                istringstream plainIn(plain);
+                ostringstream cipherOut;
+                encryptStream(plainIn, cipherOut, *alg.cipher, 1);
+                istringstream cipherIn(cipherOut.str());
+                ostringstream plainOut;
+
+                for (size_t threadsValue : threadCounts) {
+                    const auto threads = static_cast<unsigned>(threadsValue);
+                    results.push_back(measure(alg.name, "encrypt", size, threads, reps, [&] {
+                        rewind(plainIn, cipherOut);
+                        encryptStream(plainIn, cipherOut, *alg.cipher, threads);
+                    }));
+                    printRow(table, results.back());
+
+                    results.push_back(measure(alg.name, "decrypt", size, threads, reps, [&] {
+                        rewind(cipherIn, plainOut);
+                        decryptStream(cipherIn, plainOut, *alg.cipher, threads);
+                    }));
+                    printRow(table, results.back());
+
+                    if (plainOut.str() != plain) {
+                        throw runtime_error(alg.name + ": расшифрованный текст не совпадает с исходным");
+                    }
+                }
+            }
+        }
+
+        if (!csvPath.empty()) writeOutput(csvPath, [&](ostream& out) { writeCsv(out, results); });
+        if (!jsonPath.empty()) writeOutput(jsonPath, [&](ostream& out) { writeJson(out, results); });
+
+        if (!baselinePath.empty()) {
+            const size_t regressions = compareWithBaseline(table, results, baseline, tolerance);
+            if (regressions > 0) {
+                table << "Регрессий: " << regressions << "\n";
+                return 2;
+            }
+            table << "Регрессий нет\n";
+        }
+    } catch (const exception& e) {
+        cerr << "Ошибка: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
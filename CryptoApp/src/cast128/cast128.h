@@ -5,19 +5,85 @@
 #include <string>
 #include <array>
 #include <cstdint>
+#include <memory>
+#include "stream_cipher.h"
 
 constexpr size_t BLOCK_SIZE = 8;
 constexpr size_t ROUNDS = 16;
 
+// Расписание ключей CAST-128 (RFC 2144): маскирующие ключи Km и ключи
+// циклического сдвига Kr (5 бит) для каждого раунда. Вычисляется один раз
+// в generateCastKey; для ключей не длиннее 80 бит выполняется 12 раундов.
 struct CastKey {
     std::array<uint32_t, ROUNDS> Km;
     std::array<uint8_t, ROUNDS> Kr;
+    size_t rounds = ROUNDS;
 };
 
+// Ключ из пароля длиной от 5 до 16 байт (40-128 бит), короткий ключ дополняется нулями
 CastKey generateCastKey(const std::string& password);
 void encryptBlock(std::array<uint8_t, BLOCK_SIZE>& block, const CastKey& key);
 void decryptBlock(std::array<uint8_t, BLOCK_SIZE>& block, const CastKey& key);
+// Один блок по указателям; in и out могут совпадать
+void encryptBlock(const uint8_t* in, uint8_t* out, const CastKey& key);
+void decryptBlock(const uint8_t* in, uint8_t* out, const CastKey& key);
+
+// Блочная обработка буфера без копирования (аналог std::span: указатель и длина).
+// size должен быть кратен BLOCK_SIZE; in и out могут совпадать.
+void encryptBlocks(const uint8_t* in, uint8_t* out, size_t size, const CastKey& key);
+void decryptBlocks(const uint8_t* in, uint8_t* out, size_t size, const CastKey& key);
+void encryptBlocks(uint8_t* data, size_t size, const CastKey& key);
+void decryptBlocks(uint8_t* data, size_t size, const CastKey& key);
+
+// Режим ECB с дополнением PKCS#7
 std::vector<uint8_t> encryptMessage(const std::string& message, const CastKey& key);
 std::string decryptMessage(const std::vector<uint8_t>& encrypted, const CastKey& key);
 
+// То же с буфером результата от вызывающего: ёмкость out переиспользуется между вызовами
+void encryptMessage(const uint8_t* message, size_t size, const CastKey& key, std::vector<uint8_t>& out);
+void decryptMessage(const uint8_t* encrypted, size_t size, const CastKey& key, std::string& out);
+void encryptMessage(const std::string& message, const CastKey& key, std::vector<uint8_t>& out);
+void decryptMessage(const std::vector<uint8_t>& encrypted, const CastKey& key, std::string& out);
+
+// Шифрование на месте: data дополняется (до 8 байт) и шифруется, при
+// расшифровании дополнение снимается; при запасе ёмкости память не выделяется
+void encryptMessageInPlace(std::vector<uint8_t>& data, const CastKey& key);
+void decryptMessageInPlace(std::vector<uint8_t>& data, const CastKey& key);
+
+// Режим счётчика (CTR): блок гаммы i - зашифрованное значение counter + i
+// (64 бита, big-endian, по модулю 2^64), данные складываются с гаммой по XOR.
+// Шифрование и расшифрование совпадают; size любой, in и out могут совпадать.
+// Независимые блоки гаммы шифруются по CTR_INTERLEAVE за итерацию, а большой
+// буфер делится на части по потокам (threads == 0 - все ядра); результат от
+// числа потоков не зависит. Пара (ключ, counter) не должна повторяться.
+constexpr size_t CTR_INTERLEAVE = 4;
+void ctrCrypt(const uint8_t* in, uint8_t* out, size_t size, const CastKey& key,
+              uint64_t counter, unsigned threads = 0);
+void ctrCrypt(uint8_t* data, size_t size, const CastKey& key, uint64_t counter, unsigned threads = 0);
+
+// Шифр для общего файлового драйвера (common/stream_cipher.h): CTR кусками
+// по CAST128_STREAM_CHUNK байт, куски шифруются параллельно. Заголовок файла
+// (16 байт): "C8R1", 4 нулевых байта, начальный счётчик (uint64, little-endian);
+// при шифровании счётчик выбирается случайно для каждого файла.
+constexpr size_t CAST128_STREAM_CHUNK = size_t{1} << 20;
+std::unique_ptr<StreamCipher> makeCast128StreamCipher(const CastKey& key);
+
+// Реализация блочных функций (encryptBlocks, decryptBlocks, ctrCrypt) для
+// буферов от 8 блоков. По умолчанию выбирается лучшая из поддерживаемых
+// процессором (CPUID); одиночные блоки всегда обрабатываются скалярным кодом.
+enum class Cast128Impl {
+    Scalar,
+    Avx2   // 8 блоков за итерацию, S-блоки через gather
+};
+
+Cast128Impl cast128Implementation();
+const char* cast128ImplementationName(Cast128Impl impl);
+bool cast128ImplementationSupported(Cast128Impl impl);
+// Принудительный выбор (для бенчмарков и проверки); false, если процессор не
+// поддерживает impl. Не вызывать одновременно с шифрованием в других потоках.
+bool setCast128Implementation(Cast128Impl impl);
+
+// Проверка на контрольных примерах RFC 2144 (приложение B.1)
+bool cast128SelfTest();
+
 #endif // CAST128_H
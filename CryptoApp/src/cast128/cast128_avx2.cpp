@@ -0,0 +1,146 @@
+#include "cast128_avx2.h"
+#include "cast128_sbox.h"
+#include <immintrin.h>
+#include <utility>
+
+namespace {
+
+using Vec = __m256i;
+
+const int* const S1 = reinterpret_cast<const int*>(CAST_SBOX[0].data());
+const int* const S2 = reinterpret_cast<const int*>(CAST_SBOX[1].data());
+const int* const S3 = reinterpret_cast<const int*>(CAST_SBOX[2].data());
+const int* const S4 = reinterpret_cast<const int*>(CAST_SBOX[3].data());
+
+inline Vec rotl(Vec x, unsigned r) {
+    // Сдвиг на 32 даёт ноль, поэтому r == 0 обрабатывается без ветвления
+    return _mm256_or_si256(_mm256_sll_epi32(x, _mm_cvtsi32_si128(static_cast<int>(r))),
+                           _mm256_srl_epi32(x, _mm_cvtsi32_si128(static_cast<int>(32 - r))));
+}
+
+// Функция раунда типа I % 3 + 1 (RFC 2144, 2.2) для 8 блоков: четыре gather по байтам I
+template <size_t I>
+inline void feistelRound(Vec& l, Vec& r, const CastKey& key) {
+    const Vec km = _mm256_set1_epi32(static_cast<int>(key.Km[I]));
+    Vec i;
+    if constexpr (I % 3 == 0) i = _mm256_add_epi32(km, r);
+    else if constexpr (I % 3 == 1) i = _mm256_xor_si256(km, r);
+    else i = _mm256_sub_epi32(km, r);
+    i = rotl(i, key.Kr[I]);
+
+    const Vec mask = _mm256_set1_epi32(0xff);
+    const Vec a = _mm256_i32gather_epi32(S1, _mm256_srli_epi32(i, 24), 4);
+    const Vec b = _mm256_i32gather_epi32(S2, _mm256_and_si256(_mm256_srli_epi32(i, 16), mask), 4);
+    const Vec c = _mm256_i32gather_epi32(S3, _mm256_and_si256(_mm256_srli_epi32(i, 8), mask), 4);
+    const Vec d = _mm256_i32gather_epi32(S4, _mm256_and_si256(i, mask), 4);
+
+    Vec f;
+    if constexpr (I % 3 == 0) f = _mm256_add_epi32(_mm256_sub_epi32(_mm256_xor_si256(a, b), c), d);
+    else if constexpr (I % 3 == 1) f = _mm256_xor_si256(_mm256_add_epi32(_mm256_sub_epi32(a, b), c), d);
+    else f = _mm256_sub_epi32(_mm256_xor_si256(_mm256_add_epi32(a, b), c), d);
+
+    const Vec t = _mm256_xor_si256(l, f);
+    l = r;
+    r = t;
+}
+
+template <size_t... I>
+inline void encryptRounds(Vec& l, Vec& r, const CastKey& key, std::index_sequence<I...>) {
+    (feistelRound<I>(l, r, key), ...);
+}
+
+template <size_t... I>
+inline void decryptRounds(Vec& l, Vec& r, const CastKey& key, std::index_sequence<I...>) {
+    (feistelRound<sizeof...(I) - 1 - I>(l, r, key), ...);
+}
+
+inline void encrypt8(Vec& l, Vec& r, const CastKey& key) {
+    encryptRounds(l, r, key, std::make_index_sequence<12>());
+    if (key.rounds == ROUNDS) {
+        feistelRound<12>(l, r, key);
+        feistelRound<13>(l, r, key);
+        feistelRound<14>(l, r, key);
+        feistelRound<15>(l, r, key);
+    }
+}
+
+inline void decrypt8(Vec& l, Vec& r, const CastKey& key) {
+    if (key.rounds == ROUNDS) {
+        feistelRound<15>(l, r, key);
+        feistelRound<14>(l, r, key);
+        feistelRound<13>(l, r, key);
+        feistelRound<12>(l, r, key);
+    }
+    decryptRounds(l, r, key, std::make_index_sequence<12>());
+}
+
+// Перестановка байт big-endian слов в каждом 32-битном элементе
+inline Vec byteSwap(Vec x) {
+    const Vec order = _mm256_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12,
+                                       3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+    return _mm256_shuffle_epi8(x, order);
+}
+
+// 64 байта (блоки L0 R0 .. L7 R7) -> l = L0..L7, r = R0..R7
+inline void load8(const uint8_t* in, Vec& l, Vec& r) {
+    const Vec split = _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7);
+    const Vec lo = _mm256_permutevar8x32_epi32(byteSwap(_mm256_loadu_si256(reinterpret_cast<const Vec*>(in))), split);
+    const Vec hi = _mm256_permutevar8x32_epi32(byteSwap(_mm256_loadu_si256(reinterpret_cast<const Vec*>(in + 32))), split);
+    l = _mm256_permute2x128_si256(lo, hi, 0x20);
+    r = _mm256_permute2x128_si256(lo, hi, 0x31);
+}
+
+// Обратно с обменом половин на выходе сети Фейстеля: блок j = R_j L_j
+inline void pack8(Vec l, Vec r, Vec& lo, Vec& hi) {
+    const Vec merge = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+    lo = byteSwap(_mm256_permutevar8x32_epi32(_mm256_permute2x128_si256(r, l, 0x20), merge));
+    hi = byteSwap(_mm256_permutevar8x32_epi32(_mm256_permute2x128_si256(r, l, 0x31), merge));
+}
+
+inline void store8(uint8_t* out, Vec l, Vec r) {
+    Vec lo, hi;
+    pack8(l, r, lo, hi);
+    _mm256_storeu_si256(reinterpret_cast<Vec*>(out), lo);
+    _mm256_storeu_si256(reinterpret_cast<Vec*>(out + 32), hi);
+}
+
+} // namespace
+
+void encryptBlocksAvx2(const uint8_t* in, uint8_t* out, size_t groups, const CastKey& key) {
+    for (size_t g = 0; g < groups; ++g, in += 64, out += 64) {
+        Vec l, r;
+        load8(in, l, r);
+        encrypt8(l, r, key);
+        store8(out, l, r);
+    }
+}
+
+void decryptBlocksAvx2(const uint8_t* in, uint8_t* out, size_t groups, const CastKey& key) {
+    for (size_t g = 0; g < groups; ++g, in += 64, out += 64) {
+        Vec l, r;
+        load8(in, l, r);
+        decrypt8(l, r, key);
+        store8(out, l, r);
+    }
+}
+
+void ctrCryptAvx2(const uint8_t* in, uint8_t* out, size_t groups, const CastKey& key, uint64_t counter) {
+    // Счётчики counter + j: младшие половины складываются в векторе, перенос в
+    // старшие - по беззнаковому сравнению (через сдвиг знакового бита)
+    const Vec steps = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    const Vec sign = _mm256_set1_epi32(static_cast<int>(0x80000000u));
+    for (size_t g = 0; g < groups; ++g, in += 64, out += 64, counter += AVX2_LANES) {
+        const Vec base = _mm256_set1_epi32(static_cast<int>(static_cast<uint32_t>(counter)));
+        Vec r = _mm256_add_epi32(base, steps);
+        const Vec carry = _mm256_cmpgt_epi32(_mm256_xor_si256(base, sign), _mm256_xor_si256(r, sign));
+        Vec l = _mm256_sub_epi32(_mm256_set1_epi32(static_cast<int>(counter >> 32)), carry);
+        encrypt8(l, r, key);
+
+        Vec lo, hi;
+        pack8(l, r, lo, hi);
+        const Vec* src = reinterpret_cast<const Vec*>(in);
+        Vec* dst = reinterpret_cast<Vec*>(out);
+        _mm256_storeu_si256(dst, _mm256_xor_si256(_mm256_loadu_si256(src), lo));
+        _mm256_storeu_si256(dst + 1, _mm256_xor_si256(_mm256_loadu_si256(src + 1), hi));
+    }
+}
@@ -0,0 +1,20 @@
+#ifndef CAST128_AVX2_H
+#define CAST128_AVX2_H
+
+#include "cast128.h"
+#include <cstddef>
+#include <cstdint>
+
+// Ядро CAST-128 на AVX2: 8 блоков в регистрах, выборки из S-блоков через
+// gather. Внутренний заголовок библиотеки; cast128_avx2.cpp собирается
+// с -mavx2 и вызывается только после проверки процессора (cast128.cpp).
+// groups - число групп по 8 блоков (64 байта); in и out могут совпадать.
+
+constexpr size_t AVX2_LANES = 8;
+
+void encryptBlocksAvx2(const uint8_t* in, uint8_t* out, size_t groups, const CastKey& key);
+void decryptBlocksAvx2(const uint8_t* in, uint8_t* out, size_t groups, const CastKey& key);
+// CTR: гамма для counter .. counter + 8 * groups - 1
+void ctrCryptAvx2(const uint8_t* in, uint8_t* out, size_t groups, const CastKey& key, uint64_t counter);
+
+#endif // CAST128_AVX2_H
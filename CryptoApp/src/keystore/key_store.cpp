@@ -0,0 +1,217 @@
+#include "key_store.h"
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+static_assert(std::is_trivially_copyable<KeyRecord>::value && std::is_standard_layout<KeyRecord>::value,
+              "Запись ключа читается из отображения файла на месте");
+
+constexpr uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+struct KeyFileHeader {
+    char magic[4];
+    uint32_t byteOrder;
+    uint8_t algorithm;
+    uint8_t reserved[7];
+    uint64_t recordSize;
+    uint64_t checksum;
+};
+
+static_assert(sizeof(KeyFileHeader) == 32, "Заголовок файла ключа - 32 байта");
+
+uint64_t fnv1a(const void* data, size_t size) {
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    uint64_t hash = 0xcbf29ce484222325ull;
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= bytes[i];
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+
+#ifdef _WIN32
+// Запись data во временный файл рядом с path и замена им path
+bool writeAndRename(const std::string& path, const std::vector<uint8_t>& data, bool overwrite, bool& exists) {
+    const std::string tmp = path + "." + std::to_string(GetCurrentProcessId()) + ".tmp";
+    HANDLE file = CreateFileA(tmp.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_NEW, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return false;
+    DWORD written = 0;
+    bool ok = WriteFile(file, data.data(), static_cast<DWORD>(data.size()), &written, nullptr) &&
+              written == data.size() && FlushFileBuffers(file);
+    ok = CloseHandle(file) && ok;
+    if (ok) {
+        const DWORD flags = MOVEFILE_WRITE_THROUGH | (overwrite ? MOVEFILE_REPLACE_EXISTING : 0);
+        ok = MoveFileExA(tmp.c_str(), path.c_str(), flags) != 0;
+        exists = !ok && GetLastError() == ERROR_ALREADY_EXISTS;
+    }
+    if (!ok) DeleteFileA(tmp.c_str());
+    return ok;
+}
+#else
+// Запись data во временный файл рядом с path (создаётся заново, права 0600)
+// и замена им path. Без overwrite файл ставится жёсткой ссылкой: link не
+// заменяет существующий path, так что проверка и запись не разделены
+bool writeAndRename(const std::string& path, const std::vector<uint8_t>& data, bool overwrite, bool& exists) {
+    const std::string tmp = path + "." + std::to_string(::getpid()) + ".tmp";
+    const int fd = ::open(tmp.c_str(), O_WRONLY | O_CREAT | O_EXCL, 0600);
+    if (fd < 0) return false;
+    bool ok = true;
+    for (size_t done = 0; ok && done < data.size();) {
+        const ssize_t n = ::write(fd, data.data() + done, data.size() - done);
+        if (n > 0) done += static_cast<size_t>(n);
+        else ok = n < 0 && errno == EINTR;
+    }
+    ok = ok && ::fsync(fd) == 0;
+    ok = ::close(fd) == 0 && ok;
+    if (ok && overwrite) {
+        ok = ::rename(tmp.c_str(), path.c_str()) == 0;
+    } else if (ok) {
+        ok = ::link(tmp.c_str(), path.c_str()) == 0;
+        exists = !ok && errno == EEXIST;
+    }
+    if (!ok || !overwrite) ::unlink(tmp.c_str());
+    return ok;
+}
+#endif
+
+// Файл ключа содержит закрытый ключ: он пишется целиком во временный файл,
+// доступный только владельцу, и переименовывается на место. Прерванная
+// запись не портит прежний ключ, а существующий ключ без overwrite не
+// перезаписывается
+void writeKeyFile(const std::string& path, ContainerAlgorithm algorithm, const KeyRecord& record,
+                  bool overwrite) {
+    KeyFileHeader header{};
+    std::memcpy(header.magic, "CAK1", 4);
+    header.byteOrder = BYTE_ORDER_MARK;
+    header.algorithm = static_cast<uint8_t>(algorithm);
+    header.recordSize = sizeof(KeyRecord);
+    header.checksum = fnv1a(&record, sizeof(record));
+
+    std::vector<uint8_t> data(sizeof(header) + sizeof(record));
+    std::memcpy(data.data(), &header, sizeof(header));
+    std::memcpy(data.data() + sizeof(header), &record, sizeof(record));
+
+    bool exists = false;
+    if (!writeAndRename(path, data, overwrite, exists)) {
+        if (exists) {
+            throw std::runtime_error("Файл ключа уже существует: " + path);
+        }
+        throw std::runtime_error("Ошибка записи файла ключа: " + path);
+    }
+}
+
+} // namespace
+
+void saveKeyFile(const std::string& path, const RSAKeys& keys, bool overwrite) {
+    KeyRecord record{};
+    record.e = static_cast<uint64_t>(keys.publicKey);
+    record.d = static_cast<uint64_t>(keys.privateKey);
+    record.n = static_cast<uint64_t>(keys.n);
+    record.p = static_cast<uint64_t>(keys.p);
+    record.q = static_cast<uint64_t>(keys.q);
+    record.dP = static_cast<uint64_t>(keys.dP);
+    record.dQ = static_cast<uint64_t>(keys.dQ);
+    record.qInv = static_cast<uint64_t>(keys.qInv);
+
+    const RSAPrecomputed pre = precomputeRSA(keys);
+    record.montN = pre.n;
+    record.montP = pre.p;
+    record.montQ = pre.q;
+    RSAKeyContext(keys, pre).exportCodebook(record.codebook);
+
+    writeKeyFile(path, ContainerAlgorithm::RSA, record, overwrite);
+}
+
+void saveKeyFile(const std::string& path, const LUCKeys& keys, bool overwrite) {
+    KeyRecord record{};
+    record.e = static_cast<uint64_t>(keys.publicKey);
+    record.d = static_cast<uint64_t>(keys.privateKey);
+    record.n = static_cast<uint64_t>(keys.n);
+    LUCKeyContext(keys).exportCodebook(record.codebook);
+
+    writeKeyFile(path, ContainerAlgorithm::LUC, record, overwrite);
+}
+
+KeyFile::KeyFile(const std::string& path) : file_(MappedFile::openRead(path)) {
+    if (file_.size() != sizeof(KeyFileHeader) + sizeof(KeyRecord)) {
+        throw std::runtime_error("Неверный размер файла ключа: " + path);
+    }
+    KeyFileHeader header;
+    std::memcpy(&header, file_.data(), sizeof(header));
+    if (std::memcmp(header.magic, "CAK1", 4) != 0) {
+        throw std::runtime_error("Файл не является файлом ключа: " + path);
+    }
+    if (header.byteOrder != BYTE_ORDER_MARK) {
+        throw std::runtime_error("Файл ключа записан на машине с другим порядком байт: " + path);
+    }
+    if (header.algorithm != static_cast<uint8_t>(ContainerAlgorithm::RSA) &&
+        header.algorithm != static_cast<uint8_t>(ContainerAlgorithm::LUC)) {
+        throw std::runtime_error("Неизвестный алгоритм в файле ключа: " + path);
+    }
+    if (header.recordSize != sizeof(KeyRecord)) {
+        throw std::runtime_error("Неверный размер записи ключа: " + path);
+    }
+
+    // Отображение выровнено по странице, заголовок - 32 байта: запись выровнена
+    record_ = reinterpret_cast<const KeyRecord*>(file_.data() + sizeof(KeyFileHeader));
+    if (fnv1a(record_, sizeof(KeyRecord)) != header.checksum) {
+        throw std::runtime_error("Файл ключа повреждён (контрольная сумма): " + path);
+    }
+    algorithm_ = static_cast<ContainerAlgorithm>(header.algorithm);
+}
+
+void KeyFile::expect(ContainerAlgorithm algorithm) const {
+    if (algorithm_ != algorithm) {
+        throw std::invalid_argument("Файл содержит ключ другого алгоритма");
+    }
+}
+
+RSAKeys KeyFile::rsaKeys() const {
+    expect(ContainerAlgorithm::RSA);
+    RSAKeys keys{static_cast<int64_t>(record_->e), static_cast<int64_t>(record_->d),
+                 static_cast<int64_t>(record_->n)};
+    keys.p = static_cast<int64_t>(record_->p);
+    keys.q = static_cast<int64_t>(record_->q);
+    keys.dP = static_cast<int64_t>(record_->dP);
+    keys.dQ = static_cast<int64_t>(record_->dQ);
+    keys.qInv = static_cast<int64_t>(record_->qInv);
+    return keys;
+}
+
+RSAPrecomputed KeyFile::rsaPrecomputed() const {
+    expect(ContainerAlgorithm::RSA);
+    return RSAPrecomputed{record_->montN, record_->montP, record_->montQ};
+}
+
+RSAKeyContext KeyFile::rsaContext() const {
+    RSAKeyContext ctx(rsaKeys(), rsaPrecomputed());
+    ctx.importCodebook(record_->codebook);
+    return ctx;
+}
+
+LUCKeys KeyFile::lucKeys() const {
+    expect(ContainerAlgorithm::LUC);
+    return LUCKeys{static_cast<int64_t>(record_->e), static_cast<int64_t>(record_->d),
+                   static_cast<int64_t>(record_->n)};
+}
+
+LUCKeyContext KeyFile::lucContext() const {
+    LUCKeyContext ctx(lucKeys());
+    ctx.importCodebook(record_->codebook);
+    return ctx;
+}
@@ -0,0 +1,75 @@
+#ifndef KEY_STORE_H
+#define KEY_STORE_H
+
+#include <cstdint>
+#include <string>
+#include "cipher_container.h"
+#include "mapped_file.h"
+#include "../rsa/rsa.h"
+#include "../luc/luc.h"
+
+// Двоичный файл ключа RSA/LUC вместе с предвычислениями.
+//
+// Заголовок (32 байта):
+//   0  "CAK1"      - сигнатура и версия формата
+//   4  byteOrder   - 0x01020304 в порядке байт записавшей машины, uint32
+//   8  algorithm   - ContainerAlgorithm (как в контейнере шифртекста)
+//   9  0 x 7       - зарезервировано
+//   16 recordSize  - sizeof(KeyRecord), uint64
+//   24 checksum    - FNV-1a 64 от записи ключа, uint64
+// Далее запись KeyRecord как есть: файл отображается в память (mmap),
+// и запись читается на месте без разбора и копирования. Поэтому файл
+// переносим только между машинами с одинаковым порядком байт, иначе
+// загрузка отказывает по byteOrder.
+//
+// Запись содержит ключ, параметры CRT, константы Монтгомери для n, p и q
+// (только RSA) и таблицу шифрования всех 256 байт для кодовой книги, так что
+// загрузка ключа не требует ни генерации простых, ни возведений в степень.
+
+struct KeyRecord {
+    uint64_t e;
+    uint64_t d;
+    uint64_t n;
+    uint64_t p;     // p, q, dP, dQ, qInv - только RSA, иначе нули
+    uint64_t q;
+    uint64_t dP;
+    uint64_t dQ;
+    uint64_t qInv;
+    Montgomery64::Constants montN;
+    Montgomery64::Constants montP;
+    Montgomery64::Constants montQ;
+    uint64_t codebook[256];  // шифрование байта b открытым ключом
+};
+
+// Создание файла ключа; предвычисления выполняются здесь, один раз.
+// Файл доступен только владельцу (0600) и появляется целиком: запись идёт
+// во временный файл с последующим переименованием. Существующий файл
+// заменяется только при overwrite, иначе - runtime_error
+void saveKeyFile(const std::string& path, const RSAKeys& keys, bool overwrite = false);
+void saveKeyFile(const std::string& path, const LUCKeys& keys, bool overwrite = false);
+
+// Файл ключа, отображённый в память. Конструктор проверяет заголовок,
+// размер и контрольную сумму; ошибки - runtime_error.
+class KeyFile {
+public:
+    explicit KeyFile(const std::string& path);
+
+    ContainerAlgorithm algorithm() const noexcept { return algorithm_; }
+    const KeyRecord& record() const noexcept { return *record_; }
+
+    // Для ключа другого алгоритма - invalid_argument
+    RSAKeys rsaKeys() const;
+    RSAPrecomputed rsaPrecomputed() const;
+    RSAKeyContext rsaContext() const;
+    LUCKeys lucKeys() const;
+    LUCKeyContext lucContext() const;
+
+private:
+    MappedFile file_;
+    ContainerAlgorithm algorithm_;
+    const KeyRecord* record_;
+
+    void expect(ContainerAlgorithm algorithm) const;
+};
+
+#endif // KEY_STORE_H
@@ -1,6 +1,10 @@
 #include "luc.h"
+#include "../rsa/modexp.h"
+#include "block_codec.h"
+#include "cipher_container.h"
+#include "prime_sieve.h"
 #include <iostream>
-#include <fstream>
+#include <memory>
 #include <random>
 #include <cmath>
 #include <numeric>
@@ -66,71 +70,91 @@ int legendreSymbol(int64_t a, int64_t p) {
     return ls == p - 1 ? -1 : ls;
 }
 
-bool isPrime(int64_t n, int k = 5) {
-    if (n <= 1 || n == 4) return false;
-    if (n <= 3) return true;
-
-    int64_t d = n - 1;
-    while (d % 2 == 0)
-        d /= 2;
+int64_t generatePrime(int64_t min, int64_t max) {
+    // Генератор инициализируется один раз, а не на каждый вызов
+    static mt19937_64 gen(random_device{}());
+    return static_cast<int64_t>(randomPrime64(gen, static_cast<uint64_t>(min), static_cast<uint64_t>(max)));
+}
 
-    random_device rd;
-    mt19937_64 gen(rd());
-    uniform_int_distribution<int64_t> dist(2, n - 2);
+// Основные функции LUC
 
-    for (int i = 0; i < k; i++) {
-        int64_t a = dist(gen);
-        int64_t x = powmod(a, d, n);
+namespace {
 
-        if (x == 1 || x == n - 1)
-            continue;
+// Разность по модулю n для a, b из [0, n)
+inline uint64_t subMod(uint64_t a, uint64_t b, uint64_t n) {
+    return a >= b ? a - b : a - b + n;
+}
 
-        while (d != n - 1) {
-            x = (x * x) % n;
-            d *= 2;
+inline uint64_t reduceSigned(int64_t a, uint64_t n) {
+    const int64_t r = a % static_cast<int64_t>(n);
+    return r < 0 ? static_cast<uint64_t>(r) + n : static_cast<uint64_t>(r);
+}
 
-            if (x == 1) return false;
-            if (x == n - 1) break;
+// Лестница V_k(P, 1) mod n в форме Монтгомери. Хранится пара (V_j, V_j+1),
+// на каждом бите k индекс удваивается:
+//   V_2j = V_j^2 - 2,  V_2j+1 = V_j * V_j+1 - P,  V_2j+2 = V_j+1^2 - 2
+uint64_t lucasLadder(const Montgomery64& mont, uint64_t k, uint64_t P) {
+    const uint64_t n = mont.modulus();
+    const uint64_t two = mont.toMont(2);
+    const uint64_t p = mont.toMont(P);
+
+    uint64_t v0 = two;  // V_j
+    uint64_t v1 = p;    // V_j+1
+    int top = 63;
+    while (top >= 0 && ((k >> top) & 1) == 0) --top;
+    for (int i = top; i >= 0; --i) {
+        if (((k >> i) & 1) == 0) {
+            v1 = subMod(mont.mul(v0, v1), p, n);
+            v0 = subMod(mont.mul(v0, v0), two, n);
+        } else {
+            v0 = subMod(mont.mul(v0, v1), p, n);
+            v1 = subMod(mont.mul(v1, v1), two, n);
         }
-
-        if (x != n - 1) return false;
     }
-
-    return true;
+    return mont.fromMont(v0);
 }
 
-int64_t generatePrime(int64_t min, int64_t max) {
-    random_device rd;
-    mt19937_64 gen(rd());
-    uniform_int_distribution<int64_t> dist(min, max);
-
-    int64_t num;
-    do {
-        num = dist(gen);
-        if (num % 2 == 0 && num != 2)
-            num++;
-    } while (!isPrime(num));
-
-    return num;
+// Общий случай (произвольное Q или чётный модуль): та же лестница с 128-битным
+// mulmod и отдельно поддерживаемой степенью Q^j
+//   V_2j = V_j^2 - 2Q^j,  V_2j+1 = V_j * V_j+1 - P * Q^j
+uint64_t lucasLadderGeneric(uint64_t k, uint64_t P, uint64_t Q, uint64_t n) {
+    uint64_t v0 = 2 % n;
+    uint64_t v1 = P;
+    uint64_t qj = 1 % n;
+    int top = 63;
+    while (top >= 0 && ((k >> top) & 1) == 0) --top;
+    for (int i = top; i >= 0; --i) {
+        const bool bit = (k >> i) & 1;
+        const uint64_t cross = subMod(mulmod(v0, v1, n), mulmod(P, qj, n), n);
+        if (bit) {
+            const uint64_t qj1 = mulmod(qj, Q, n);
+            v1 = subMod(mulmod(v1, v1, n), mulmod(2, qj1, n), n);
+            v0 = cross;
+            qj = mulmod(qj, qj1, n);
+        } else {
+            v0 = subMod(mulmod(v0, v0, n), mulmod(2, qj, n), n);
+            v1 = cross;
+            qj = mulmod(qj, qj, n);
+        }
+    }
+    return v0;
 }
 
-// Основные функции LUC
+} // namespace
 
 int64_t lucasSequence(int64_t k, int64_t P, int64_t Q, int64_t n) {
+    if (n <= 0 || k < 0) {
+        throw invalid_argument("Некорректные параметры последовательности Люка");
+    }
     if (n == 1) return 0;
 
-    int64_t V_prev = 2 % n;  // V_0
-    int64_t V_curr = P % n;  // V_1
-
-    for (int64_t i = 2; i <= k; ++i) {
-        int64_t V_next = (P * V_curr - Q * V_prev) % n;
-        if (V_next < 0) V_next += n;
-
-        V_prev = V_curr;
-        V_curr = V_next;
+    const uint64_t un = static_cast<uint64_t>(n);
+    const uint64_t p = reduceSigned(P, un);
+    const uint64_t q = reduceSigned(Q, un);
+    if (q == 1 && (un & 1) && un > 2) {
+        return static_cast<int64_t>(lucasLadder(Montgomery64(un), static_cast<uint64_t>(k), p));
     }
-
-    return V_curr;
+    return static_cast<int64_t>(lucasLadderGeneric(static_cast<uint64_t>(k), p, q, un));
 }
 
 LUCKeys generateLUCKeys() {
@@ -147,8 +171,9 @@ LUCKeys generateLUCKeys() {
     // Вычисление модуля
     keys.n = p * q;
 
-    // Вычисление функции Кармайкла
-    int64_t lambda = lcm(p - legendreSymbol(p, 5), q - legendreSymbol(q, 5));
+    // Показатель, не зависящий от сообщения: V_de(m) = m при de = 1 по модулю
+    // НОК(p-1, p+1, q-1, q+1), какими бы ни были символы Лежандра (m^2 - 4 | p), (m^2 - 4 | q)
+    int64_t lambda = lcm(lcm(p - 1, p + 1), lcm(q - 1, q + 1));
 
     // Выбор открытой экспоненты
     int64_t e = 65537;
@@ -163,69 +188,121 @@ LUCKeys generateLUCKeys() {
     return keys;
 }
 
-vector<int64_t> encryptMessageLUC(const string& message, int64_t e, int64_t n) {
-    vector<int64_t> encrypted;
+LUCKeyContext::LUCKeyContext(const LUCKeys& keys)
+    : keys_(keys),
+      codebook_(keys.publicKey != 0
+                    ? ByteCodebook::Transform([e = keys.publicKey, n = keys.n](uint64_t m) {
+                          return static_cast<uint64_t>(lucasSequence(e, static_cast<int64_t>(m), 1, n));
+                      })
+                    : nullptr,
+                keys.privateKey != 0
+                    ? ByteCodebook::Transform([d = keys.privateKey, n = keys.n](uint64_t c) {
+                          return static_cast<uint64_t>(lucasSequence(d, static_cast<int64_t>(c), 1, n));
+                      })
+                    : nullptr) {
+    if (keys.n < 256) {
+        throw invalid_argument("Модуль LUC должен быть не меньше 256");
+    }
+}
 
+vector<int64_t> LUCKeyContext::encryptMessage(const string& message) {
+    vector<int64_t> encrypted;
+    encrypted.reserve(message.size());
     for (char c : message) {
-        int64_t m = static_cast<int64_t>(static_cast<unsigned char>(c));
-        encrypted.push_back(lucasSequence(e, m, 1, n));
+        encrypted.push_back(encryptByte(static_cast<uint8_t>(c)));
     }
-
     return encrypted;
 }
 
-string decryptMessageLUC(const vector<int64_t>& encrypted, int64_t d, int64_t n) {
+string LUCKeyContext::decryptMessage(const vector<int64_t>& encrypted) {
     string decrypted;
-
+    decrypted.reserve(encrypted.size());
     for (int64_t num : encrypted) {
-        int64_t m = lucasSequence(d, num, 1, n);
-        decrypted += static_cast<char>(m);
+        decrypted += decryptWord(num);
     }
-
     return decrypted;
 }
 
-void encryptFileLUC(const string& inputFile, const string& outputFile, int64_t e, int64_t n) {
-    ifstream in(inputFile, ios::binary);
-    if (!in) {
-        throw runtime_error("Не удалось открыть входной файл: " + inputFile);
-    }
+vector<int64_t> encryptMessageLUC(const string& message, int64_t e, int64_t n) {
+    return LUCKeyContext(LUCKeys{e, 0, n}).encryptMessage(message);
+}
 
-    ofstream out(outputFile);
-    if (!out) {
-        throw runtime_error("Не удалось создать выходной файл: " + outputFile);
-    }
+string decryptMessageLUC(const vector<int64_t>& encrypted, int64_t d, int64_t n) {
+    return LUCKeyContext(LUCKeys{0, d, n}).decryptMessage(encrypted);
+}
 
-    char c;
-    while (in.get(c)) {
-        int64_t m = static_cast<int64_t>(static_cast<unsigned char>(c));
-        int64_t encrypted = lucasSequence(e, m, 1, n);
-        out << encrypted << " ";
+vector<int64_t> encryptMessageLUCBlocks(const string& message, int64_t e, int64_t n) {
+    const size_t k = blockBytesForModulus(static_cast<uint64_t>(n));
+    if (k == 0) {
+        throw invalid_argument("Модуль LUC слишком мал для блочного режима");
     }
 
-    in.close();
-    out.close();
+    const Montgomery64 mont(static_cast<uint64_t>(n));
+    vector<int64_t> encrypted;
+    encrypted.reserve(paddedSize(message.size(), k) / k);
+    forEachPaddedBlock(message, k, [&](uint64_t m) {
+        encrypted.push_back(static_cast<int64_t>(lucasLadder(mont, static_cast<uint64_t>(e), m)));
+    });
+    return encrypted;
 }
 
-void decryptFileLUC(const string& inputFile, const string& outputFile, int64_t d, int64_t n) {
-    ifstream in(inputFile);
-    if (!in) {
-        throw runtime_error("Не удалось открыть входной файл: " + inputFile);
+string decryptMessageLUCBlocks(const vector<int64_t>& encrypted, int64_t d, int64_t n) {
+    const size_t k = blockBytesForModulus(static_cast<uint64_t>(n));
+    if (k == 0) {
+        throw invalid_argument("Модуль LUC слишком мал для блочного режима");
     }
 
-    ofstream out(outputFile, ios::binary);
-    if (!out) {
-        throw runtime_error("Не удалось создать выходной файл: " + outputFile);
+    const Montgomery64 mont(static_cast<uint64_t>(n));
+    string decrypted(encrypted.size() * k, '\0');
+    auto* out = reinterpret_cast<uint8_t*>(&decrypted[0]);
+    for (size_t i = 0; i < encrypted.size(); ++i) {
+        const uint64_t c = static_cast<uint64_t>(encrypted[i]);
+        if (c >= static_cast<uint64_t>(n)) {
+            throw runtime_error("Блок шифртекста не меньше модуля");
+        }
+        unpackBlock(lucasLadder(mont, static_cast<uint64_t>(d), c), k, out + i * k);
     }
+    stripPadding(decrypted, k);
+    return decrypted;
+}
 
-    int64_t num;
-    while (in >> num) {
-        int64_t decrypted = lucasSequence(d, num, 1, n);
-        out << static_cast<char>(decrypted);
-    }
+unique_ptr<StreamCipher> makeLUCStreamCipher(const LUCKeyContext& ctx) {
+    auto shared = make_shared<LUCKeyContext>(ctx);
+    shared->warmUp();
+    return makeContainerStreamCipher(
+        "LUC", ContainerAlgorithm::LUC, static_cast<uint64_t>(ctx.keys().n), 1,
+        [shared] {
+            auto own = make_shared<LUCKeyContext>(*shared);
+            return [own](uint64_t m) { return static_cast<uint64_t>(own->encryptByte(static_cast<uint8_t>(m))); };
+        },
+        [shared] {
+            auto own = make_shared<LUCKeyContext>(*shared);
+            return [own](uint64_t w) {
+                return static_cast<uint64_t>(static_cast<uint8_t>(own->decryptWord(static_cast<int64_t>(w))));
+            };
+        });
+}
+
+// Прогрев остаётся в ctx: следующий вызов с тем же контекстом не вычисляет
+// V_e заново, а копии для потоков обработки создаёт makeLUCStreamCipher
+void encryptFileLUC(const string& inputFile, const string& outputFile, LUCKeyContext& ctx, unsigned threads) {
+    ctx.warmUp();
+    encryptFileStream(inputFile, outputFile, *makeLUCStreamCipher(ctx), threads);
+}
+
+void decryptFileLUC(const string& inputFile, const string& outputFile, LUCKeyContext& ctx, unsigned threads) {
+    ctx.warmUp();
+    decryptFileStream(inputFile, outputFile, *makeLUCStreamCipher(ctx), threads);
+}
+
+void encryptFileLUC(const string& inputFile, const string& outputFile, int64_t e, int64_t n, unsigned threads) {
+    LUCKeyContext ctx(LUCKeys{e, 0, n});
+    encryptFileLUC(inputFile, outputFile, ctx, threads);
+}
 
-    in.close();
-    out.close();
+void decryptFileLUC(const string& inputFile, const string& outputFile, int64_t d, int64_t n, unsigned threads) {
+    LUCKeyContext ctx(LUCKeys{0, d, n});
+    decryptFileLUC(inputFile, outputFile, ctx, threads);
 }
 
 void run_luc_crypto() {
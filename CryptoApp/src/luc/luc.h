@@ -2,8 +2,11 @@
 #define LUC_H
 
 #include <cstdint>
+#include <memory>
 #include <vector>
 #include <string>
+#include "byte_codebook.h"
+#include "stream_cipher.h"
 
 // Объявление недостающих функций
 int64_t modInverse(int64_t a, int64_t m);
@@ -17,8 +20,59 @@ struct LUCKeys {
     int64_t n;
 };
 
+// Контекст ключа LUC для побайтового шифрования с кодовой книгой:
+// последовательность Люка для каждого значения байта вычисляется не более одного раза.
+// privateKey == 0 - только открытый ключ, publicKey == 0 - только закрытый.
+class LUCKeyContext {
+public:
+    explicit LUCKeyContext(const LUCKeys& keys);
+
+    const LUCKeys& keys() const noexcept { return keys_; }
+
+    int64_t encryptByte(uint8_t byte) { return static_cast<int64_t>(codebook_.encrypt(byte)); }
+    char decryptWord(int64_t word) { return static_cast<char>(codebook_.decrypt(static_cast<uint64_t>(word))); }
+
+    std::vector<int64_t> encryptMessage(const std::string& message);
+    std::string decryptMessage(const std::vector<int64_t>& encrypted);
+
+    ByteCodebook::Stats codebookStats() const noexcept { return codebook_.stats(); }
+    void warmUp() { codebook_.warmUp(); }
+    // Таблица шифрования всех 256 байт (см. ByteCodebook::exportTable)
+    void exportCodebook(uint64_t* table) { codebook_.exportTable(table); }
+    void importCodebook(const uint64_t* table) { codebook_.importTable(table); }
+
+private:
+    LUCKeys keys_;
+    ByteCodebook codebook_;
+};
+
+// V_k(P, Q) mod n; O(log k) умножений по модулю (лестница удвоения индекса)
+int64_t lucasSequence(int64_t k, int64_t P, int64_t Q, int64_t n);
+
 LUCKeys generateLUCKeys();
 std::vector<int64_t> encryptMessageLUC(const std::string& message, int64_t e, int64_t n);
 std::string decryptMessageLUC(const std::vector<int64_t>& encrypted, int64_t d, int64_t n);
 
+// Блочный режим: несколько байт на блок по размеру модуля, дополнение PKCS#7
+std::vector<int64_t> encryptMessageLUCBlocks(const std::string& message, int64_t e, int64_t n);
+std::string decryptMessageLUCBlocks(const std::vector<int64_t>& encrypted, int64_t d, int64_t n);
+
+// Шифр для общего файлового драйвера (common/stream_cipher.h): побайтовый
+// двоичный контейнер (common/cipher_container.h), стоимость байта - обращение
+// к кодовой книге; каждый поток обработки работает с копией прогретого ctx
+std::unique_ptr<StreamCipher> makeLUCStreamCipher(const LUCKeyContext& ctx);
+
+// Шифрование файлов через makeLUCStreamCipher и encryptFileStream/decryptFileStream.
+// Куски файла обрабатываются в threads потоках (0 - все ядра) копиями контекста,
+// поэтому счётчики кодовой книги ctx отражают только прогрев.
+void encryptFileLUC(const std::string& inputFile, const std::string& outputFile, LUCKeyContext& ctx,
+                    unsigned threads = 0);
+void decryptFileLUC(const std::string& inputFile, const std::string& outputFile, LUCKeyContext& ctx,
+                    unsigned threads = 0);
+
+void encryptFileLUC(const std::string& inputFile, const std::string& outputFile, int64_t e, int64_t n,
+                    unsigned threads = 0);
+void decryptFileLUC(const std::string& inputFile, const std::string& outputFile, int64_t d, int64_t n,
+                    unsigned threads = 0);
+
 #endif
\ No newline at end of file
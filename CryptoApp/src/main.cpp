@@ -1,14 +1,43 @@
+#include <cctype>
+#include <cerrno>
+#include <cstdlib>
+#include <fstream>
 #include <iostream>
 #include <limits>
+#include <memory>
+#include <stdexcept>
 #include <string>
 #include <vector>
 #include "cast128/cast128.h"
 #include "rsa/rsa.h"
 #include "luc/luc.h"
-#include <iomanip>
+#include "keystore/key_store.h"
+#include "hex_codec.h"
 
 using namespace std;
 
+// Файлы ключей по умолчанию (текущий каталог)
+const string DEFAULT_RSA_KEY_FILE = "rsa.key";
+const string DEFAULT_LUC_KEY_FILE = "luc.key";
+
+bool fileExists(const string& path) {
+    return ifstream(path).good();
+}
+
+// Ключи интерактивного режима создаются один раз за сеанс (или читаются из
+// файла ключа по умолчанию) и используются всеми действиями меню
+const RSAKeys& sessionRSAKeys() {
+    static const RSAKeys keys =
+        fileExists(DEFAULT_RSA_KEY_FILE) ? KeyFile(DEFAULT_RSA_KEY_FILE).rsaKeys() : generateRSAKeys();
+    return keys;
+}
+
+const LUCKeys& sessionLUCKeys() {
+    static const LUCKeys keys =
+        fileExists(DEFAULT_LUC_KEY_FILE) ? KeyFile(DEFAULT_LUC_KEY_FILE).lucKeys() : generateLUCKeys();
+    return keys;
+}
+
 void clearInputBuffer() {
     cin.clear();
     cin.ignore(numeric_limits<streamsize>::max(), '\n');
@@ -21,18 +50,14 @@ void handleCast128() {
     cout << "Введите сообщение: ";
     getline(cin, message);
     
-    cout << "Введите пароль: ";
+    cout << "Введите пароль (5-16 байт): ";
     getline(cin, password);
 
     try {
         CastKey key = generateCastKey(password);
         vector<uint8_t> encrypted = encryptMessage(message, key);
 
-        cout << "\nРезультат шифрования (hex): ";
-        for (uint8_t byte : encrypted) {
-            cout << hex << setw(2) << setfill('0') << static_cast<int>(byte);
-        }
-        cout << dec << endl;
+        cout << "\nРезультат шифрования (hex): " << hexEncode(encrypted) << endl;
 
         string decrypted = decryptMessage(encrypted, key);
         cout << "Результат дешифрования: " << decrypted << endl;
@@ -49,8 +74,8 @@ void handleRSA() {
     getline(cin, message);
 
     try {
-        RSAKeys keys = generateRSAKeys();
-        vector<int64_t> encrypted = encryptMessageRSA(message, keys.publicKey, keys.n);
+        const RSAKeys& keys = sessionRSAKeys();
+        vector<int64_t> encrypted = encryptMessageRSABlocks(message, keys.publicKey, keys.n);
 
         cout << "\nОткрытый ключ (e, n): (" << keys.publicKey << ", " << keys.n << ")\n";
         cout << "Закрытый ключ (d, n): (" << keys.privateKey << ", " << keys.n << ")\n";
@@ -60,7 +85,7 @@ void handleRSA() {
         }
         cout << endl;
 
-        string decrypted = decryptMessageRSA(encrypted, keys.privateKey, keys.n);
+        string decrypted = decryptMessageRSABlocks(encrypted, keys);
         cout << "Результат дешифрования: " << decrypted << endl;
     } catch (const exception& e) {
         cerr << "Ошибка: " << e.what() << endl;
@@ -75,8 +100,8 @@ void handleLUC() {
     getline(cin, message);
 
     try {
-        LUCKeys keys = generateLUCKeys();
-        vector<int64_t> encrypted = encryptMessageLUC(message, keys.publicKey, keys.n);
+        const LUCKeys& keys = sessionLUCKeys();
+        vector<int64_t> encrypted = encryptMessageLUCBlocks(message, keys.publicKey, keys.n);
 
         cout << "\nОткрытый ключ (e, n): (" << keys.publicKey << ", " << keys.n << ")\n";
         cout << "Закрытый ключ (d, n): (" << keys.privateKey << ", " << keys.n << ")\n";
@@ -86,7 +111,7 @@ void handleLUC() {
         }
         cout << endl;
 
-        string decrypted = decryptMessageLUC(encrypted, keys.privateKey, keys.n);
+        string decrypted = decryptMessageLUCBlocks(encrypted, keys.privateKey, keys.n);
         cout << "Результат дешифрования: " << decrypted << endl;
     } catch (const exception& e) {
         cerr << "Ошибка: " << e.what() << endl;
@@ -102,9 +127,145 @@ void showMainMenu() {
     cout << "Выберите алгоритм: ";
 }
 
-int main() {
+void printUsage() {
+    cerr << "Использование:\n"
+         << "  CryptoApp                                     - интерактивное меню\n"
+         << "  CryptoApp --alg rsa|luc --genkey [--key файл] [--force]\n"
+         << "  CryptoApp --alg rsa|luc [--key файл] [--threads N] --encrypt вход выход\n"
+         << "  CryptoApp --alg rsa|luc [--key файл] [--threads N] --decrypt вход выход\n"
+         << "  CryptoApp --alg cast128 --password пароль [--threads N] --encrypt|--decrypt вход выход\n"
+         << "N - число потоков обработки, 0 (по умолчанию) - все ядра.\n"
+         << "Файл ключа по умолчанию - rsa.key или luc.key; он создаётся только\n"
+         << "через --genkey, существующий ключ заменяется лишь с --force.\n";
+}
+
+struct CommandLine {
+    string algorithm;
+    string keyFile;
+    string password;  // CAST-128
+    string action;  // genkey, encrypt, decrypt
+    string input;
+    string output;
+    unsigned threads = 0;
+    bool force = false;  // --genkey поверх существующего файла ключа
+};
+
+// Верхняя граница --threads: больше потоков обработки файлу не нужно
+constexpr unsigned long MAX_THREADS = 1024;
+
+// Число потоков: 0 (все ядра) .. MAX_THREADS; strtoul сам пропускает
+// пробелы и принимает "-1", поэтому первая литера проверяется отдельно
+bool parseThreads(const char* text, unsigned& threads) {
+    if (!isdigit(static_cast<unsigned char>(text[0]))) return false;
+    char* end = nullptr;
+    errno = 0;
+    const unsigned long value = strtoul(text, &end, 10);
+    if (*end != '\0' || errno == ERANGE || value > MAX_THREADS) return false;
+    threads = static_cast<unsigned>(value);
+    return true;
+}
+
+// false - ошибка в аргументах
+bool parseCommandLine(int argc, char* argv[], CommandLine& cmd) {
+    for (int i = 1; i < argc; ++i) {
+        const string arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (arg == "--alg" && hasValue) {
+            cmd.algorithm = argv[++i];
+        } else if (arg == "--key" && hasValue) {
+            cmd.keyFile = argv[++i];
+        } else if (arg == "--password" && hasValue) {
+            cmd.password = argv[++i];
+        } else if (arg == "--threads" && hasValue) {
+            if (!parseThreads(argv[++i], cmd.threads)) {
+                cerr << "Некорректное число потоков: " << argv[i] << " (0 - все ядра, до " << MAX_THREADS << ")\n";
+                return false;
+            }
+        } else if (arg == "--force") {
+            cmd.force = true;
+        } else if (arg == "--genkey" && cmd.action.empty()) {
+            cmd.action = "genkey";
+        } else if ((arg == "--encrypt" || arg == "--decrypt") && cmd.action.empty() && i + 2 < argc) {
+            cmd.action = arg.substr(2);
+            cmd.input = argv[++i];
+            cmd.output = argv[++i];
+        } else {
+            return false;
+        }
+    }
+    if (cmd.force && cmd.action != "genkey") return false;
+    if (cmd.algorithm == "cast128") {
+        return !cmd.password.empty() && (cmd.action == "encrypt" || cmd.action == "decrypt");
+    }
+    if (cmd.algorithm != "rsa" && cmd.algorithm != "luc") return false;
+    if (cmd.keyFile.empty()) cmd.keyFile = cmd.algorithm == "rsa" ? DEFAULT_RSA_KEY_FILE : DEFAULT_LUC_KEY_FILE;
+    return !cmd.action.empty();
+}
+
+void generateKeyFile(const CommandLine& cmd) {
+    // Проверка до генерации, чтобы не ждать её зря; саму замену без --force
+    // всё равно отклоняет saveKeyFile
+    if (!cmd.force && fileExists(cmd.keyFile)) {
+        throw runtime_error("Файл ключа " + cmd.keyFile +
+                            " уже существует; --force заменит его, и шифртексты старого ключа не расшифруются");
+    }
+    if (cmd.algorithm == "rsa") {
+        const RSAKeys keys = generateRSAKeys();
+        saveKeyFile(cmd.keyFile, keys, cmd.force);
+        cerr << "Ключ RSA (e, n) = (" << keys.publicKey << ", " << keys.n << ") записан в " << cmd.keyFile << endl;
+    } else {
+        const LUCKeys keys = generateLUCKeys();
+        saveKeyFile(cmd.keyFile, keys, cmd.force);
+        cerr << "Ключ LUC (e, n) = (" << keys.publicKey << ", " << keys.n << ") записан в " << cmd.keyFile << endl;
+    }
+}
+
+// Пакетный режим: ключ читается из файла (отображением в память), поэтому
+// повторные запуски не генерируют ключ и не заполняют кодовую книгу заново
+int runCommandLine(int argc, char* argv[]) {
+    CommandLine cmd;
+    if (!parseCommandLine(argc, argv, cmd)) {
+        printUsage();
+        return 2;
+    }
+
+    try {
+        if (cmd.action == "genkey") {
+            generateKeyFile(cmd);
+            return 0;
+        }
+
+        unique_ptr<StreamCipher> cipher;
+        if (cmd.algorithm == "cast128") {
+            cipher = makeCast128StreamCipher(generateCastKey(cmd.password));
+        } else {
+            if (!fileExists(cmd.keyFile)) {
+                throw runtime_error("Файл ключа " + cmd.keyFile + " не найден; создайте его через --genkey");
+            }
+            const KeyFile key(cmd.keyFile);
+            cipher = cmd.algorithm == "rsa" ? makeRSAStreamCipher(key.rsaKeys(), key.rsaPrecomputed())
+                                            : makeLUCStreamCipher(key.lucContext());
+        }
+        // Все шифры - через общий драйвер: чтение, обработка в потоках, запись по порядку
+        if (cmd.action == "encrypt") {
+            encryptFileStream(cmd.input, cmd.output, *cipher, cmd.threads);
+        } else {
+            decryptFileStream(cmd.input, cmd.output, *cipher, cmd.threads);
+        }
+    } catch (const exception& e) {
+        cerr << "Ошибка: " << e.what() << endl;
+        return 1;
+    }
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
     setlocale(LC_ALL, "Russian");
-    
+
+    if (argc > 1) {
+        return runCommandLine(argc, argv);
+    }
+
     int choice;
     do {
         showMainMenu();
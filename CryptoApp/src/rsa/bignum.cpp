@@ -0,0 +1,666 @@
+#include "bignum.h"
+#include <algorithm>
+#include <stdexcept>
+
+using Limb = BigInt::Limb;
+using DLimb = BigInt::DLimb;
+
+namespace {
+
+// Ниже этой длины (в лимбах) школьное умножение быстрее Карацубы
+constexpr size_t KARATSUBA_THRESHOLD = 24;
+
+// Операции над массивами лимбов одинаковой длины n
+
+Limb addN(Limb* r, const Limb* a, const Limb* b, size_t n) {
+    DLimb carry = 0;
+    for (size_t i = 0; i < n; ++i) {
+        DLimb s = static_cast<DLimb>(a[i]) + b[i] + carry;
+        r[i] = static_cast<Limb>(s);
+        carry = s >> 32;
+    }
+    return static_cast<Limb>(carry);
+}
+
+Limb subN(Limb* r, const Limb* a, const Limb* b, size_t n) {
+    Limb borrow = 0;
+    for (size_t i = 0; i < n; ++i) {
+        DLimb d = static_cast<DLimb>(a[i]) - b[i] - borrow;
+        r[i] = static_cast<Limb>(d);
+        borrow = static_cast<Limb>((d >> 32) & 1);
+    }
+    return borrow;
+}
+
+int cmpN(const Limb* a, const Limb* b, size_t n) {
+    for (size_t i = n; i-- > 0;) {
+        if (a[i] != b[i]) return a[i] < b[i] ? -1 : 1;
+    }
+    return 0;
+}
+
+// r[0 .. an+bn) = a * b
+void mulSchool(Limb* r, const Limb* a, size_t an, const Limb* b, size_t bn) {
+    std::fill(r, r + an + bn, 0);
+    for (size_t i = 0; i < an; ++i) {
+        DLimb carry = 0;
+        const DLimb ai = a[i];
+        for (size_t j = 0; j < bn; ++j) {
+            DLimb t = ai * b[j] + r[i + j] + carry;
+            r[i + j] = static_cast<Limb>(t);
+            carry = t >> 32;
+        }
+        r[i + bn] = static_cast<Limb>(carry);
+    }
+}
+
+// Рабочий буфер для karatsuba(n): 3n на уровень, суммарно не больше 6n
+size_t karatsubaWorkspace(size_t n) {
+    return 6 * n + KARATSUBA_THRESHOLD;
+}
+
+// r[0 .. 2n) = a * b, вычитательный вариант Карацубы:
+// a0*b1 + a1*b0 = a0*b0 + a1*b1 - (a0 - a1)*(b0 - b1)
+void karatsuba(Limb* r, const Limb* a, const Limb* b, size_t n, Limb* ws) {
+    if (n < KARATSUBA_THRESHOLD || (n & 1)) {
+        mulSchool(r, a, n, b, n);
+        return;
+    }
+
+    const size_t h = n / 2;
+    Limb* da = ws;
+    Limb* db = ws + h;
+    Limb* m = ws + 2 * h;
+    Limb* t = m + n;
+    Limb* next = t + n;
+
+    karatsuba(r, a, b, h, next);              // z0 = a0*b0
+    karatsuba(r + n, a + h, b + h, h, next);  // z2 = a1*b1
+
+    const bool negA = cmpN(a, a + h, h) < 0;
+    if (negA) subN(da, a + h, a, h); else subN(da, a, a + h, h);
+    const bool negB = cmpN(b, b + h, h) < 0;
+    if (negB) subN(db, b + h, b, h); else subN(db, b, b + h, h);
+    karatsuba(m, da, db, h, next);
+
+    // t = z0 + z2 -+ |a0 - a1| * |b0 - b1|, старший перенос в c (значение неотрицательно)
+    int64_t c = addN(t, r, r + n, n);
+    if (negA == negB) {
+        c -= subN(t, t, m, n);
+    } else {
+        c += addN(t, t, m, n);
+    }
+
+    DLimb carry = static_cast<DLimb>(addN(r + h, r + h, t, n)) + static_cast<DLimb>(c);
+    for (size_t i = h + n; carry && i < 2 * n; ++i) {
+        DLimb s = static_cast<DLimb>(r[i]) + carry;
+        r[i] = static_cast<Limb>(s);
+        carry = s >> 32;
+    }
+}
+
+// r[0 .. an+bn) = a * b с выбором алгоритма по длинам операндов
+void mulLimbs(Limb* r, const Limb* a, size_t an, const Limb* b, size_t bn, Limb* ws) {
+    if (an == bn && an >= KARATSUBA_THRESHOLD) {
+        karatsuba(r, a, b, an, ws);
+    } else {
+        mulSchool(r, a, an, b, bn);
+    }
+}
+
+int leadingZeros(Limb x) {
+    int n = 0;
+    if (x == 0) return 32;
+    while ((x & 0x80000000u) == 0) {
+        x <<= 1;
+        ++n;
+    }
+    return n;
+}
+
+// Простые числа до 2000 для пробного деления
+const std::vector<uint32_t>& smallPrimes() {
+    static const std::vector<uint32_t> primes = [] {
+        const uint32_t limit = 2000;
+        std::vector<bool> composite(limit + 1, false);
+        std::vector<uint32_t> result;
+        for (uint32_t i = 2; i <= limit; ++i) {
+            if (composite[i]) continue;
+            result.push_back(i);
+            for (uint32_t j = i * i; j <= limit; j += i) composite[j] = true;
+        }
+        return result;
+    }();
+    return primes;
+}
+
+} // namespace
+
+// ---------------------------------------------------------------------------
+// BigInt
+
+BigInt::BigInt(uint64_t value) {
+    while (value) {
+        limbs_.push_back(static_cast<Limb>(value));
+        value >>= 32;
+    }
+}
+
+void BigInt::trim() noexcept {
+    while (!limbs_.empty() && limbs_.back() == 0) limbs_.pop_back();
+}
+
+BigInt BigInt::fromLimbs(const Limb* limbs, size_t count) {
+    BigInt r;
+    r.limbs_.assign(limbs, limbs + count);
+    r.trim();
+    return r;
+}
+
+BigInt BigInt::fromBytes(const uint8_t* data, size_t size) {
+    BigInt r;
+    r.limbs_.assign((size + 3) / 4, 0);
+    for (size_t i = 0; i < size; ++i) {
+        size_t pos = size - 1 - i;  // номер байта от младшего
+        r.limbs_[pos / 4] |= static_cast<Limb>(data[i]) << (8 * (pos % 4));
+    }
+    r.trim();
+    return r;
+}
+
+std::vector<uint8_t> BigInt::toBytes(size_t size) const {
+    if ((bitLength() + 7) / 8 > size) {
+        throw std::length_error("Число не помещается в заданное число байт");
+    }
+    std::vector<uint8_t> out(size, 0);
+    for (size_t pos = 0; pos < limbs_.size() * 4 && pos < size; ++pos) {
+        out[size - 1 - pos] = static_cast<uint8_t>(limbs_[pos / 4] >> (8 * (pos % 4)));
+    }
+    return out;
+}
+
+BigInt BigInt::fromHex(const std::string& hex) {
+    BigInt r;
+    size_t bit = 0;
+    for (size_t i = hex.size(); i-- > 0;) {
+        char ch = hex[i];
+        Limb v;
+        if (ch >= '0' && ch <= '9') v = ch - '0';
+        else if (ch >= 'a' && ch <= 'f') v = ch - 'a' + 10;
+        else if (ch >= 'A' && ch <= 'F') v = ch - 'A' + 10;
+        else throw std::invalid_argument("Некорректная шестнадцатеричная строка");
+        if (bit / 32 >= r.limbs_.size()) r.limbs_.push_back(0);
+        r.limbs_[bit / 32] |= v << (bit % 32);
+        bit += 4;
+    }
+    r.trim();
+    return r;
+}
+
+std::string BigInt::toHex() const {
+    if (isZero()) return "0";
+    static const char digits[] = "0123456789abcdef";
+    std::string out;
+    for (size_t i = limbs_.size(); i-- > 0;) {
+        for (int shift = 28; shift >= 0; shift -= 4) {
+            out += digits[(limbs_[i] >> shift) & 0xF];
+        }
+    }
+    size_t first = out.find_first_not_of('0');
+    return out.substr(first);
+}
+
+std::string BigInt::toDecimal() const {
+    if (isZero()) return "0";
+    std::vector<Limb> cur = limbs_;
+    std::vector<uint32_t> chunks;  // по 9 десятичных цифр
+    while (!cur.empty()) {
+        DLimb rem = 0;
+        for (size_t i = cur.size(); i-- > 0;) {
+            DLimb v = (rem << 32) | cur[i];
+            cur[i] = static_cast<Limb>(v / 1000000000u);
+            rem = v % 1000000000u;
+        }
+        chunks.push_back(static_cast<uint32_t>(rem));
+        while (!cur.empty() && cur.back() == 0) cur.pop_back();
+    }
+    std::string out = std::to_string(chunks.back());
+    for (size_t i = chunks.size() - 1; i-- > 0;) {
+        std::string part = std::to_string(chunks[i]);
+        out += std::string(9 - part.size(), '0') + part;
+    }
+    return out;
+}
+
+BigInt BigInt::random(unsigned bits, std::mt19937_64& gen) {
+    BigInt r;
+    if (bits == 0) return r;
+    r.limbs_.resize((bits + 31) / 32);
+    for (auto& limb : r.limbs_) limb = static_cast<Limb>(gen());
+    const unsigned top = (bits - 1) % 32;
+    r.limbs_.back() &= (top == 31) ? 0xFFFFFFFFu : ((Limb{1} << (top + 1)) - 1);
+    r.limbs_.back() |= Limb{1} << top;
+    return r;
+}
+
+BigInt BigInt::randomBelow(const BigInt& bound, std::mt19937_64& gen) {
+    if (bound.isZero()) throw std::invalid_argument("Верхняя граница должна быть положительной");
+    const unsigned bits = bound.bitLength();
+    while (true) {
+        BigInt r;
+        r.limbs_.resize((bits + 31) / 32);
+        for (auto& limb : r.limbs_) limb = static_cast<Limb>(gen());
+        const unsigned top = bits % 32;
+        if (top) r.limbs_.back() &= (Limb{1} << top) - 1;
+        r.trim();
+        if (r < bound) return r;
+    }
+}
+
+unsigned BigInt::bitLength() const noexcept {
+    if (limbs_.empty()) return 0;
+    return static_cast<unsigned>(limbs_.size() * 32 - leadingZeros(limbs_.back()));
+}
+
+bool BigInt::testBit(unsigned bit) const noexcept {
+    size_t idx = bit / 32;
+    return idx < limbs_.size() && ((limbs_[idx] >> (bit % 32)) & 1);
+}
+
+uint64_t BigInt::toUint64() const noexcept {
+    uint64_t v = 0;
+    if (limbs_.size() > 0) v |= limbs_[0];
+    if (limbs_.size() > 1) v |= static_cast<uint64_t>(limbs_[1]) << 32;
+    return v;
+}
+
+int BigInt::compare(const BigInt& a, const BigInt& b) noexcept {
+    if (a.limbs_.size() != b.limbs_.size()) return a.limbs_.size() < b.limbs_.size() ? -1 : 1;
+    return cmpN(a.limbs_.data(), b.limbs_.data(), a.limbs_.size());
+}
+
+BigInt operator+(const BigInt& a, const BigInt& b) {
+    const BigInt& big = a.limbs_.size() >= b.limbs_.size() ? a : b;
+    const BigInt& small = a.limbs_.size() >= b.limbs_.size() ? b : a;
+    BigInt r;
+    r.limbs_.resize(big.limbs_.size() + 1);
+    DLimb carry = 0;
+    for (size_t i = 0; i < big.limbs_.size(); ++i) {
+        DLimb s = static_cast<DLimb>(big.limbs_[i]) + carry;
+        if (i < small.limbs_.size()) s += small.limbs_[i];
+        r.limbs_[i] = static_cast<Limb>(s);
+        carry = s >> 32;
+    }
+    r.limbs_.back() = static_cast<Limb>(carry);
+    r.trim();
+    return r;
+}
+
+BigInt operator-(const BigInt& a, const BigInt& b) {
+    if (a < b) throw std::underflow_error("Отрицательный результат вычитания");
+    BigInt r;
+    r.limbs_.resize(a.limbs_.size());
+    Limb borrow = 0;
+    for (size_t i = 0; i < a.limbs_.size(); ++i) {
+        DLimb d = static_cast<DLimb>(a.limbs_[i]) - borrow;
+        if (i < b.limbs_.size()) d -= b.limbs_[i];
+        r.limbs_[i] = static_cast<Limb>(d);
+        borrow = static_cast<Limb>((d >> 32) & 1);
+    }
+    r.trim();
+    return r;
+}
+
+BigInt operator*(const BigInt& a, const BigInt& b) {
+    if (a.isZero() || b.isZero()) return BigInt();
+    const size_t an = a.limbs_.size();
+    const size_t bn = b.limbs_.size();
+    BigInt r;
+
+    // Близкие по длине операнды выравниваются до общей длины для Карацубы
+    const size_t n = std::max(an, bn);
+    if (std::min(an, bn) >= KARATSUBA_THRESHOLD && std::min(an, bn) * 2 >= n) {
+        std::vector<Limb> pa(a.limbs_), pb(b.limbs_);
+        pa.resize(n, 0);
+        pb.resize(n, 0);
+        std::vector<Limb> ws(karatsubaWorkspace(n));
+        r.limbs_.resize(2 * n);
+        karatsuba(r.limbs_.data(), pa.data(), pb.data(), n, ws.data());
+    } else {
+        r.limbs_.resize(an + bn);
+        mulSchool(r.limbs_.data(), a.limbs_.data(), an, b.limbs_.data(), bn);
+    }
+    r.trim();
+    return r;
+}
+
+BigInt BigInt::operator<<(unsigned shift) const {
+    if (isZero()) return *this;
+    const size_t limbShift = shift / 32;
+    const unsigned bitShift = shift % 32;
+    BigInt r;
+    r.limbs_.assign(limbs_.size() + limbShift + 1, 0);
+    for (size_t i = 0; i < limbs_.size(); ++i) {
+        DLimb v = static_cast<DLimb>(limbs_[i]) << bitShift;
+        r.limbs_[i + limbShift] |= static_cast<Limb>(v);
+        r.limbs_[i + limbShift + 1] |= static_cast<Limb>(v >> 32);
+    }
+    r.trim();
+    return r;
+}
+
+BigInt BigInt::operator>>(unsigned shift) const {
+    const size_t limbShift = shift / 32;
+    const unsigned bitShift = shift % 32;
+    if (limbShift >= limbs_.size()) return BigInt();
+    BigInt r;
+    r.limbs_.assign(limbs_.size() - limbShift, 0);
+    for (size_t i = 0; i < r.limbs_.size(); ++i) {
+        DLimb v = limbs_[i + limbShift];
+        if (i + limbShift + 1 < limbs_.size()) {
+            v |= static_cast<DLimb>(limbs_[i + limbShift + 1]) << 32;
+        }
+        r.limbs_[i] = static_cast<Limb>(v >> bitShift);
+    }
+    r.trim();
+    return r;
+}
+
+uint32_t BigInt::modSmall(uint32_t m) const noexcept {
+    DLimb rem = 0;
+    for (size_t i = limbs_.size(); i-- > 0;) {
+        rem = ((rem << 32) | limbs_[i]) % m;
+    }
+    return static_cast<uint32_t>(rem);
+}
+
+void BigInt::divmod(const BigInt& a, const BigInt& b, BigInt& quotient, BigInt& remainder) {
+    if (b.isZero()) throw std::domain_error("Деление на ноль");
+    if (a < b) {
+        quotient = BigInt();
+        remainder = a;
+        return;
+    }
+
+    const size_t m = a.limbs_.size();
+    const size_t n = b.limbs_.size();
+    BigInt q;
+    q.limbs_.assign(m - n + 1, 0);
+
+    if (n == 1) {
+        DLimb rem = 0;
+        const DLimb d = b.limbs_[0];
+        for (size_t i = m; i-- > 0;) {
+            DLimb v = (rem << 32) | a.limbs_[i];
+            q.limbs_[i] = static_cast<Limb>(v / d);
+            rem = v % d;
+        }
+        q.trim();
+        quotient = std::move(q);
+        remainder = BigInt(rem);
+        return;
+    }
+
+    // Нормализация: старший бит делителя должен быть установлен
+    const int s = leadingZeros(b.limbs_.back());
+    std::vector<Limb> vn(n), un(m + 1);
+    for (size_t i = n - 1; i > 0; --i) {
+        vn[i] = static_cast<Limb>((static_cast<DLimb>(b.limbs_[i]) << s) | (static_cast<DLimb>(b.limbs_[i - 1]) >> (32 - s)));
+    }
+    vn[0] = b.limbs_[0] << s;
+    un[m] = static_cast<Limb>(static_cast<DLimb>(a.limbs_[m - 1]) >> (32 - s));
+    for (size_t i = m - 1; i > 0; --i) {
+        un[i] = static_cast<Limb>((static_cast<DLimb>(a.limbs_[i]) << s) | (static_cast<DLimb>(a.limbs_[i - 1]) >> (32 - s)));
+    }
+    un[0] = a.limbs_[0] << s;
+
+    const DLimb base = DLimb{1} << 32;
+    for (size_t j = m - n + 1; j-- > 0;) {
+        // Оценка очередной цифры частного по двум старшим лимбам
+        DLimb num = (static_cast<DLimb>(un[j + n]) << 32) | un[j + n - 1];
+        DLimb qhat = num / vn[n - 1];
+        DLimb rhat = num % vn[n - 1];
+        while (qhat >= base || qhat * vn[n - 2] > ((rhat << 32) | un[j + n - 2])) {
+            --qhat;
+            rhat += vn[n - 1];
+            if (rhat >= base) break;
+        }
+
+        // un[j .. j+n] -= qhat * vn
+        int64_t t;
+        DLimb k = 0;
+        for (size_t i = 0; i < n; ++i) {
+            DLimb p = qhat * vn[i];
+            t = static_cast<int64_t>(un[i + j]) - static_cast<int64_t>(k) - static_cast<int64_t>(p & 0xFFFFFFFFu);
+            un[i + j] = static_cast<Limb>(t);
+            k = (p >> 32) - (t >> 32);
+        }
+        t = static_cast<int64_t>(un[j + n]) - static_cast<int64_t>(k);
+        un[j + n] = static_cast<Limb>(t);
+
+        q.limbs_[j] = static_cast<Limb>(qhat);
+        if (t < 0) {
+            // Оценка оказалась на единицу больше: возвращаем делитель
+            --q.limbs_[j];
+            DLimb carry = 0;
+            for (size_t i = 0; i < n; ++i) {
+                DLimb sum = static_cast<DLimb>(un[i + j]) + vn[i] + carry;
+                un[i + j] = static_cast<Limb>(sum);
+                carry = sum >> 32;
+            }
+            un[j + n] = static_cast<Limb>(un[j + n] + carry);
+        }
+    }
+
+    BigInt r;
+    r.limbs_.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+        r.limbs_[i] = static_cast<Limb>((un[i] >> s) | (static_cast<DLimb>(un[i + 1]) << (32 - s)));
+    }
+    r.trim();
+    q.trim();
+    quotient = std::move(q);
+    remainder = std::move(r);
+}
+
+BigInt operator/(const BigInt& a, const BigInt& b) {
+    BigInt q, r;
+    BigInt::divmod(a, b, q, r);
+    return q;
+}
+
+BigInt operator%(const BigInt& a, const BigInt& b) {
+    BigInt q, r;
+    BigInt::divmod(a, b, q, r);
+    return r;
+}
+
+BigInt gcd(const BigInt& a, const BigInt& b) {
+    BigInt x = a, y = b;
+    while (!y.isZero()) {
+        BigInt r = x % y;
+        x = std::move(y);
+        y = std::move(r);
+    }
+    return x;
+}
+
+BigInt modInverse(const BigInt& a, const BigInt& m) {
+    // Расширенный алгоритм Евклида; коэффициенты хранятся по модулю m,
+    // поэтому знаковая арифметика не нужна: t_i * a = r_i (mod m)
+    BigInt r0 = m, r1 = a % m;
+    BigInt t0 = 0, t1 = 1;
+    while (!r1.isZero()) {
+        BigInt q, r;
+        BigInt::divmod(r0, r1, q, r);
+        r0 = std::move(r1);
+        r1 = std::move(r);
+
+        BigInt qt = (q * t1) % m;
+        BigInt tn = t0 >= qt ? t0 - qt : t0 + m - qt;
+        t0 = std::move(t1);
+        t1 = std::move(tn);
+    }
+    if (r0 != BigInt(1)) {
+        throw std::runtime_error("Обратный элемент не существует");
+    }
+    return t0;
+}
+
+// ---------------------------------------------------------------------------
+// MontgomeryContext
+
+MontgomeryContext::MontgomeryContext(const BigInt& mod) : n_(mod), k_(mod.limbs().size()) {
+    if (!mod.isOdd() || mod <= BigInt(1)) {
+        throw std::invalid_argument("Модуль Монтгомери должен быть нечётным и больше 1");
+    }
+
+    const Limb n0 = mod.limbs()[0];
+    Limb inv = n0;
+    for (int i = 0; i < 4; ++i) inv *= 2 - n0 * inv;
+    nInv_ = static_cast<Limb>(0u - inv);
+
+    one_ = (BigInt(1) << static_cast<unsigned>(32 * k_)) % n_;
+    r2_ = (BigInt(1) << static_cast<unsigned>(64 * k_)) % n_;
+}
+
+size_t MontgomeryContext::workspaceSize() const noexcept {
+    return 2 * k_ + 1 + karatsubaWorkspace(k_);
+}
+
+void MontgomeryContext::toLimbs(const BigInt& a, Limb* out) const {
+    const auto& src = a.limbs();
+    std::fill(out, out + k_, 0);
+    std::copy(src.begin(), src.end(), out);
+}
+
+void MontgomeryContext::mul(Limb* out, const Limb* a, const Limb* b, Limb* ws) const {
+    Limb* t = ws;
+    mulLimbs(t, a, k_, b, k_, ws + 2 * k_ + 1);
+    t[2 * k_] = 0;
+
+    // REDC: последовательно обнуляем младшие k лимбов прибавлением кратных n
+    const Limb* n = n_.limbs().data();
+    for (size_t i = 0; i < k_; ++i) {
+        const DLimb m = static_cast<Limb>(t[i] * nInv_);
+        DLimb carry = 0;
+        for (size_t j = 0; j < k_; ++j) {
+            DLimb s = m * n[j] + t[i + j] + carry;
+            t[i + j] = static_cast<Limb>(s);
+            carry = s >> 32;
+        }
+        for (size_t j = i + k_; carry; ++j) {
+            DLimb s = static_cast<DLimb>(t[j]) + carry;
+            t[j] = static_cast<Limb>(s);
+            carry = s >> 32;
+        }
+    }
+
+    Limb* res = t + k_;
+    if (res[k_] != 0 || cmpN(res, n, k_) >= 0) {
+        subN(res, res, n, k_);
+    }
+    std::copy(res, res + k_, out);
+}
+
+BigInt MontgomeryContext::pow(const BigInt& base, const BigInt& exp) const {
+    if (exp.isZero()) return BigInt(1) % n_;
+
+    std::vector<Limb> ws(workspaceSize());
+    std::vector<Limb> r2(k_), x(k_), sq(k_), result(k_);
+    toLimbs(r2_, r2.data());
+    toLimbs(base < n_ ? base : base % n_, x.data());
+    mul(x.data(), x.data(), r2.data(), ws.data());  // x -> форма Монтгомери
+
+    const unsigned bits = exp.bitLength();
+    const int w = bits > 1024 ? 6 : bits > 256 ? 5 : bits > 64 ? 4 : bits > 16 ? 3 : 1;
+
+    // Нечётные степени x^1, x^3, ..., x^(2^w - 1)
+    const size_t tableSize = size_t{1} << (w - 1);
+    std::vector<Limb> table(tableSize * k_);
+    std::copy(x.begin(), x.end(), table.begin());
+    if (w > 1) {
+        mul(sq.data(), x.data(), x.data(), ws.data());
+        for (size_t i = 1; i < tableSize; ++i) {
+            mul(&table[i * k_], &table[(i - 1) * k_], sq.data(), ws.data());
+        }
+    }
+
+    bool started = false;
+    int i = static_cast<int>(bits) - 1;
+    while (i >= 0) {
+        if (!exp.testBit(i)) {
+            if (started) mul(result.data(), result.data(), result.data(), ws.data());
+            --i;
+            continue;
+        }
+        int low = std::max(i - w + 1, 0);
+        while (!exp.testBit(low)) ++low;
+        size_t value = 0;
+        for (int b = i; b >= low; --b) value = (value << 1) | (exp.testBit(b) ? 1 : 0);
+
+        const Limb* entry = &table[(value >> 1) * k_];
+        if (started) {
+            for (int s = 0; s < i - low + 1; ++s) {
+                mul(result.data(), result.data(), result.data(), ws.data());
+            }
+            mul(result.data(), result.data(), entry, ws.data());
+        } else {
+            std::copy(entry, entry + k_, result.begin());
+            started = true;
+        }
+        i = low - 1;
+    }
+
+    // Выход из формы Монтгомери: умножение на 1
+    std::fill(x.begin(), x.end(), 0);
+    x[0] = 1;
+    mul(result.data(), result.data(), x.data(), ws.data());
+    return BigInt::fromLimbs(result.data(), k_);
+}
+
+BigInt MontgomeryContext::mulMod(const BigInt& a, const BigInt& b) const {
+    std::vector<Limb> ws(workspaceSize());
+    std::vector<Limb> x(k_), y(k_), r2(k_);
+    toLimbs(a < n_ ? a : a % n_, x.data());
+    toLimbs(b < n_ ? b : b % n_, y.data());
+    toLimbs(r2_, r2.data());
+    mul(x.data(), x.data(), y.data(), ws.data());   // a*b*R^-1
+    mul(x.data(), x.data(), r2.data(), ws.data());  // a*b
+    return BigInt::fromLimbs(x.data(), k_);
+}
+
+// ---------------------------------------------------------------------------
+
+bool isProbablePrime(const BigInt& n, std::mt19937_64& gen, int rounds) {
+    if (n < BigInt(2)) return false;
+    for (uint32_t p : smallPrimes()) {
+        if (n == BigInt(p)) return true;
+        if (n.modSmall(p) == 0) return false;
+    }
+
+    // n - 1 = d * 2^s
+    const BigInt nMinus1 = n - BigInt(1);
+    unsigned s = 0;
+    while (!nMinus1.testBit(s)) ++s;
+    const BigInt d = nMinus1 >> s;
+
+    MontgomeryContext ctx(n);
+    const BigInt range = n - BigInt(3);
+    for (int r = 0; r < rounds; ++r) {
+        BigInt a = BigInt::randomBelow(range, gen) + BigInt(2);
+        BigInt x = ctx.pow(a, d);
+        if (x == BigInt(1) || x == nMinus1) continue;
+
+        bool witness = true;
+        for (unsigned i = 1; i < s; ++i) {
+            x = ctx.mulMod(x, x);
+            if (x == nMinus1) {
+                witness = false;
+                break;
+            }
+        }
+        if (witness) return false;
+    }
+    return true;
+}
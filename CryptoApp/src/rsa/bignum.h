@@ -0,0 +1,108 @@
+#ifndef BIGNUM_H
+#define BIGNUM_H
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+// Неотрицательное целое произвольной точности.
+// Хранится вектором 32-битных лимбов от младшего к старшему без ведущих нулей,
+// промежуточные произведения помещаются в uint64_t (без __int128, переносимо на MSVC).
+class BigInt {
+public:
+    using Limb = uint32_t;
+    using DLimb = uint64_t;
+    static constexpr unsigned LIMB_BITS = 32;
+
+    BigInt() = default;
+    BigInt(uint64_t value);
+
+    // Big-endian байтовое представление
+    static BigInt fromBytes(const uint8_t* data, size_t size);
+    std::vector<uint8_t> toBytes(size_t size) const;
+
+    static BigInt fromHex(const std::string& hex);
+    std::string toHex() const;
+    std::string toDecimal() const;
+
+    // Случайное число ровно из bits бит (старший бит установлен)
+    static BigInt random(unsigned bits, std::mt19937_64& gen);
+    // Случайное число из [0, bound)
+    static BigInt randomBelow(const BigInt& bound, std::mt19937_64& gen);
+
+    bool isZero() const noexcept { return limbs_.empty(); }
+    bool isOdd() const noexcept { return !limbs_.empty() && (limbs_[0] & 1); }
+    unsigned bitLength() const noexcept;
+    bool testBit(unsigned bit) const noexcept;
+    uint64_t toUint64() const noexcept;
+
+    const std::vector<Limb>& limbs() const noexcept { return limbs_; }
+    static BigInt fromLimbs(const Limb* limbs, size_t count);
+
+    static int compare(const BigInt& a, const BigInt& b) noexcept;
+
+    friend BigInt operator+(const BigInt& a, const BigInt& b);
+    friend BigInt operator-(const BigInt& a, const BigInt& b);  // требует a >= b
+    friend BigInt operator*(const BigInt& a, const BigInt& b);
+    friend BigInt operator/(const BigInt& a, const BigInt& b);
+    friend BigInt operator%(const BigInt& a, const BigInt& b);
+    BigInt operator<<(unsigned shift) const;
+    BigInt operator>>(unsigned shift) const;
+
+    // Деление с остатком (алгоритм D Кнута)
+    static void divmod(const BigInt& a, const BigInt& b, BigInt& quotient, BigInt& remainder);
+    // Остаток от деления на малое число
+    uint32_t modSmall(uint32_t m) const noexcept;
+
+    friend bool operator==(const BigInt& a, const BigInt& b) noexcept { return a.limbs_ == b.limbs_; }
+    friend bool operator!=(const BigInt& a, const BigInt& b) noexcept { return a.limbs_ != b.limbs_; }
+    friend bool operator<(const BigInt& a, const BigInt& b) noexcept { return compare(a, b) < 0; }
+    friend bool operator>(const BigInt& a, const BigInt& b) noexcept { return compare(a, b) > 0; }
+    friend bool operator<=(const BigInt& a, const BigInt& b) noexcept { return compare(a, b) <= 0; }
+    friend bool operator>=(const BigInt& a, const BigInt& b) noexcept { return compare(a, b) >= 0; }
+
+private:
+    std::vector<Limb> limbs_;
+
+    void trim() noexcept;
+};
+
+BigInt gcd(const BigInt& a, const BigInt& b);
+// Обратный элемент a по модулю m; бросает std::runtime_error, если НОД(a, m) != 1
+BigInt modInverse(const BigInt& a, const BigInt& m);
+
+// Контекст Монтгомери для фиксированного нечётного модуля произвольной длины.
+// Произведение считается умножением Карацубы (или школьным для малых длин),
+// затем сокращается REDC; R = 2^(32*k), k - число лимбов модуля.
+class MontgomeryContext {
+public:
+    explicit MontgomeryContext(const BigInt& mod);
+
+    const BigInt& modulus() const noexcept { return n_; }
+
+    // base^exp mod n методом скользящего окна в форме Монтгомери
+    BigInt pow(const BigInt& base, const BigInt& exp) const;
+    // a * b mod n для чисел в обычной форме
+    BigInt mulMod(const BigInt& a, const BigInt& b) const;
+
+private:
+    using Limb = BigInt::Limb;
+
+    BigInt n_;
+    size_t k_;
+    Limb nInv_;     // -n^-1 mod 2^32
+    BigInt r2_;     // R^2 mod n
+    BigInt one_;    // R mod n
+
+    void toLimbs(const BigInt& a, Limb* out) const;
+    // out = a * b * R^-1 mod n; все операнды по k_ лимбов, ws - рабочий буфер workspaceSize()
+    void mul(Limb* out, const Limb* a, const Limb* b, Limb* ws) const;
+    size_t workspaceSize() const noexcept;
+};
+
+// Вероятностная проверка простоты: пробное деление и rounds раундов Миллера-Рабина
+bool isProbablePrime(const BigInt& n, std::mt19937_64& gen, int rounds = 24);
+
+#endif // BIGNUM_H
@@ -0,0 +1,25 @@
+#include "modexp.h"
+
+uint64_t mulmod(uint64_t a, uint64_t b, uint64_t mod) {
+    return mulMod64(a, b, mod);
+}
+
+uint64_t powmodBinary(uint64_t base, uint64_t exp, uint64_t mod) {
+    if (mod == 1) return 0;
+    return modmul_detail::powWith(base % mod, exp, 1,
+                                  [mod](uint64_t a, uint64_t b) { return mulMod64(a, b, mod); });
+}
+
+uint64_t powmodWindow(uint64_t base, uint64_t exp, uint64_t mod) {
+    if (mod == 1) return 0;
+    return modmul_detail::slidingWindowPow(base % mod, exp, 1,
+                                           [mod](uint64_t a, uint64_t b) { return mulMod64(a, b, mod); });
+}
+
+uint64_t powmod(uint64_t base, uint64_t exp, uint64_t mod) {
+    if (mod == 1) return 0;
+    if (mod & 1) {
+        return Montgomery64(mod).pow(base, exp);
+    }
+    return powmodWindow(base, exp, mod);
+}
@@ -0,0 +1,24 @@
+#ifndef MODEXP_H
+#define MODEXP_H
+
+#include <cstdint>
+#include "modmul.h"
+
+// Модульная арифметика для 64-битных модулей.
+// Все функции работают со значениями без знака и модулем mod > 0.
+// Умножение Монтгомери (Montgomery64), 128-битное mulMod64 и скользящее окно
+// - общие из common/modmul.h; здесь только прежние точки входа CryptoApp.
+
+// (a * b) % mod через 128-битное промежуточное произведение
+uint64_t mulmod(uint64_t a, uint64_t b, uint64_t mod);
+
+// Бинарное возведение в степень (square-and-multiply), O(log exp) умножений
+uint64_t powmodBinary(uint64_t base, uint64_t exp, uint64_t mod);
+
+// Возведение в степень методом скользящего окна
+uint64_t powmodWindow(uint64_t base, uint64_t exp, uint64_t mod);
+
+// Основная точка входа: Монтгомери для нечётного модуля, иначе скользящее окно
+uint64_t powmod(uint64_t base, uint64_t exp, uint64_t mod);
+
+#endif // MODEXP_H
@@ -1,6 +1,11 @@
 #include "rsa.h"
+#include "modexp.h"
+#include "block_codec.h"
+#include "cipher_container.h"
+#include "prime_sieve.h"
 #include <random>
 #include <cmath>
+#include <stdexcept>
 
 int64_t gcd(int64_t a, int64_t b) {
     while (b != 0) {
@@ -27,39 +32,357 @@ int64_t modInverse(int64_t a, int64_t m) {
     return x;
 }
 
+int64_t generatePrime64(std::mt19937_64& gen, int64_t min, int64_t max) {
+    return static_cast<int64_t>(randomPrime64(gen, static_cast<uint64_t>(min), static_cast<uint64_t>(max)));
+}
+
 RSAKeys generateRSAKeys() {
+    std::random_device rd;
+    std::mt19937_64 gen(rd());
+
     RSAKeys keys;
-    int64_t p = 61;
-    int64_t q = 53;
+    int64_t p = generatePrime64(gen, int64_t{1} << 30, (int64_t{1} << 31) - 1);
+    int64_t q = generatePrime64(gen, int64_t{1} << 30, (int64_t{1} << 31) - 1);
+    while (p == q) {
+        q = generatePrime64(gen, int64_t{1} << 30, (int64_t{1} << 31) - 1);
+    }
     keys.n = p * q;
     int64_t phi = (p - 1) * (q - 1);
-    int64_t e = 17;
+    int64_t e = 65537;
+    while (gcd(e, phi) != 1) {
+        e += 2;
+    }
     keys.publicKey = e;
     keys.privateKey = modInverse(e, phi);
+
+    keys.p = p;
+    keys.q = q;
+    keys.dP = keys.privateKey % (p - 1);
+    keys.dQ = keys.privateKey % (q - 1);
+    keys.qInv = modInverse(q % p, p);
     return keys;
 }
 
-std::vector<int64_t> encryptMessageRSA(const std::string& message, int64_t e, int64_t n) {
+// Сколько кандидатов просматривается от одного случайного старта: средний
+// промежуток между простыми порядка ln(2^bits), этого хватает с запасом
+constexpr uint32_t MAX_SIEVE_OFFSET = 1u << 16;
+
+// Простое ровно из bits бит с двумя старшими единичными битами,
+// чтобы произведение двух таких простых имело ровно 2 * bits бит
+BigInt generateBigPrime(unsigned bits, std::mt19937_64& gen) {
+    const BigInt e(65537);
+    CandidateSieve sieve;
+    while (true) {
+        BigInt start = BigInt::random(bits, gen);
+        if (!start.testBit(bits - 2)) start = start + (BigInt(1) << (bits - 2));
+        if (!start.isOdd()) start = start + BigInt(1);
+
+        // Остатки старта считаются один раз, дальше - шаг по 2 с обновлением;
+        // дорогой тест только для кандидатов без малых делителей
+        bool survives = sieve.reset([&start](uint32_t p) { return start.modSmall(p); });
+        for (uint32_t offset = 0; offset < MAX_SIEVE_OFFSET; offset += 2, survives = sieve.step()) {
+            if (!survives) continue;
+            const BigInt candidate = start + BigInt(offset);
+            if (candidate.bitLength() != bits) break;
+            if (!isProbablePrime(candidate, gen, 8)) continue;
+            if (gcd(candidate - BigInt(1), e) != BigInt(1)) continue;
+            return candidate;
+        }
+    }
+}
+
+RSABigKeys generateRSABigKeys(unsigned bits) {
+    if (bits < 64 || bits % 2 != 0) {
+        throw std::invalid_argument("Размер ключа RSA должен быть чётным и не меньше 64 бит");
+    }
+
+    std::random_device rd;
+    std::mt19937_64 gen((static_cast<uint64_t>(rd()) << 32) ^ rd());
+
+    BigInt p = generateBigPrime(bits / 2, gen);
+    BigInt q = generateBigPrime(bits / 2, gen);
+    while (p == q) {
+        q = generateBigPrime(bits / 2, gen);
+    }
+
+    RSABigKeys keys;
+    keys.bits = bits;
+    keys.n = p * q;
+    BigInt phi = (p - BigInt(1)) * (q - BigInt(1));
+    keys.publicKey = BigInt(65537);
+    keys.privateKey = modInverse(keys.publicKey, phi);
+
+    keys.p = p;
+    keys.q = q;
+    keys.dP = keys.privateKey % (p - BigInt(1));
+    keys.dQ = keys.privateKey % (q - BigInt(1));
+    keys.qInv = modInverse(q, p);
+    return keys;
+}
+
+BigInt encryptRSA(const BigInt& message, const RSABigKeys& keys) {
+    if (message >= keys.n) {
+        throw std::invalid_argument("Сообщение должно быть меньше модуля RSA");
+    }
+    return MontgomeryContext(keys.n).pow(message, keys.publicKey);
+}
+
+BigInt decryptRSA(const BigInt& cipher, const RSABigKeys& keys, bool useCRT) {
+    if (cipher >= keys.n) {
+        throw std::invalid_argument("Шифртекст должен быть меньше модуля RSA");
+    }
+    if (!useCRT || keys.p.isZero() || keys.q.isZero()) {
+        return MontgomeryContext(keys.n).pow(cipher, keys.privateKey);
+    }
+
+    // m1 = c^dP mod p, m2 = c^dQ mod q, m = m2 + q * (qInv * (m1 - m2) mod p)
+    BigInt m1 = MontgomeryContext(keys.p).pow(cipher % keys.p, keys.dP);
+    BigInt m2 = MontgomeryContext(keys.q).pow(cipher % keys.q, keys.dQ);
+    BigInt m2p = m2 % keys.p;
+    BigInt diff = m1 >= m2p ? m1 - m2p : m1 + keys.p - m2p;
+    BigInt h = (keys.qInv * diff) % keys.p;
+    return m2 + h * keys.q;
+}
+
+namespace {
+
+// Закрытый ключ в форме CRT с готовыми контекстами Монтгомери для p и q
+class CRTDecryptor {
+public:
+    explicit CRTDecryptor(const RSAKeys& keys)
+        : p_(static_cast<uint64_t>(keys.p)), q_(static_cast<uint64_t>(keys.q)),
+          dP_(static_cast<uint64_t>(keys.dP)), dQ_(static_cast<uint64_t>(keys.dQ)),
+          qInv_(static_cast<uint64_t>(keys.qInv)), montP_(p_), montQ_(q_) {}
+
+    CRTDecryptor(const RSAKeys& keys, const RSAPrecomputed& pre)
+        : p_(static_cast<uint64_t>(keys.p)), q_(static_cast<uint64_t>(keys.q)),
+          dP_(static_cast<uint64_t>(keys.dP)), dQ_(static_cast<uint64_t>(keys.dQ)),
+          qInv_(static_cast<uint64_t>(keys.qInv)), montP_(pre.p), montQ_(pre.q) {
+        if (pre.p.n != p_ || pre.q.n != q_) {
+            throw std::invalid_argument("Константы Монтгомери не соответствуют p и q");
+        }
+    }
+
+    // Формула Гарнера: две экспоненты по модулям p и q вместо одной по n
+    uint64_t operator()(uint64_t c) const {
+        uint64_t m1 = montP_.pow(c % p_, dP_);
+        uint64_t m2 = montQ_.pow(c % q_, dQ_);
+        uint64_t diff = (m1 + p_ - m2 % p_) % p_;
+        // Для 31-битных p из generateRSAKeys() произведение помещается в 64 бита
+        uint64_t h = p_ < (uint64_t{1} << 32) ? qInv_ * diff % p_ : mulmod(qInv_, diff, p_);
+        return m2 + h * q_;
+    }
+
+private:
+    uint64_t p_, q_, dP_, dQ_, qInv_;
+    Montgomery64 montP_;
+    Montgomery64 montQ_;
+};
+
+bool hasCRT(const RSAKeys& keys) {
+    return keys.p != 0 && keys.q != 0;
+}
+
+uint64_t checkedModulus(const RSAKeys& keys) {
+    const uint64_t n = static_cast<uint64_t>(keys.n);
+    if (n < 256) {
+        throw std::invalid_argument("Модуль RSA должен быть не меньше 256");
+    }
+    return n;
+}
+
+// Контекст Монтгомери для модуля n: из готовых констант, если они заданы
+Montgomery64 montgomeryFor(uint64_t n, const Montgomery64::Constants& pre) {
+    if (pre.n == 0) return Montgomery64(n);
+    if (pre.n != n) {
+        throw std::invalid_argument("Константы Монтгомери не соответствуют модулю n");
+    }
+    return Montgomery64(pre);
+}
+
+// Операция открытым ключом для кодовой книги (пустая, если ключ не задан)
+ByteCodebook::Transform encryptTransform(const RSAKeys& keys, const RSAPrecomputed& pre = {}) {
+    if (keys.publicKey == 0) return nullptr;
+    const uint64_t n = checkedModulus(keys);
+    const uint64_t e = static_cast<uint64_t>(keys.publicKey);
+    if (n & 1) {
+        Montgomery64 mont = montgomeryFor(n, pre.n);
+        return [mont, e](uint64_t m) { return mont.pow(m, e); };
+    }
+    return [n, e](uint64_t m) { return powmod(m, e, n); };
+}
+
+// Операция закрытым ключом: через CRT, если параметры заданы
+ByteCodebook::Transform decryptTransform(const RSAKeys& keys, const RSAPrecomputed& pre = {}) {
+    if (hasCRT(keys)) {
+        CRTDecryptor crt = pre.p.n != 0 ? CRTDecryptor(keys, pre) : CRTDecryptor(keys);
+        return [crt](uint64_t c) { return crt(c); };
+    }
+    if (keys.privateKey == 0) return nullptr;
+    const uint64_t n = checkedModulus(keys);
+    const uint64_t d = static_cast<uint64_t>(keys.privateKey);
+    if (n & 1) {
+        Montgomery64 mont = montgomeryFor(n, pre.n);
+        return [mont, d](uint64_t c) { return mont.pow(c, d); };
+    }
+    return [n, d](uint64_t c) { return powmod(c, d, n); };
+}
+
+} // namespace
+
+RSAPrecomputed precomputeRSA(const RSAKeys& keys) {
+    RSAPrecomputed pre;
+    const uint64_t n = static_cast<uint64_t>(keys.n);
+    if (n >= 3 && (n & 1)) pre.n = Montgomery64(n).constants();
+    if (hasCRT(keys)) {
+        pre.p = Montgomery64(static_cast<uint64_t>(keys.p)).constants();
+        pre.q = Montgomery64(static_cast<uint64_t>(keys.q)).constants();
+    }
+    return pre;
+}
+
+RSAKeyContext::RSAKeyContext(const RSAKeys& keys)
+    : keys_(keys),
+      codebook_(encryptTransform(keys), decryptTransform(keys)) {}
+
+RSAKeyContext::RSAKeyContext(const RSAKeys& keys, const RSAPrecomputed& pre)
+    : keys_(keys),
+      codebook_(encryptTransform(keys, pre), decryptTransform(keys, pre)) {}
+
+std::vector<int64_t> RSAKeyContext::encryptMessage(const std::string& message) {
     std::vector<int64_t> encrypted;
+    encrypted.reserve(message.size());
     for (char c : message) {
-        int64_t m = static_cast<int64_t>(c);
-        int64_t encryptedChar = 1;
-        for (int64_t i = 0; i < e; ++i) {
-            encryptedChar = (encryptedChar * m) % n;
-        }
-        encrypted.push_back(encryptedChar);
+        encrypted.push_back(encryptByte(static_cast<uint8_t>(c)));
     }
     return encrypted;
 }
 
-std::string decryptMessageRSA(const std::vector<int64_t>& encrypted, int64_t d, int64_t n) {
+std::string RSAKeyContext::decryptMessage(const std::vector<int64_t>& encrypted) {
     std::string decrypted;
+    decrypted.reserve(encrypted.size());
     for (int64_t num : encrypted) {
-        int64_t decryptedChar = 1;
-        for (int64_t i = 0; i < d; ++i) {
-            decryptedChar = (decryptedChar * num) % n;
+        decrypted += decryptWord(num);
+    }
+    return decrypted;
+}
+
+// Побайтовые функции работают через временный контекст ключа:
+// повторяющиеся символы берутся из кодовой книги без возведения в степень
+std::vector<int64_t> encryptMessageRSA(const std::string& message, int64_t e, int64_t n) {
+    return RSAKeyContext(RSAKeys{e, 0, n}).encryptMessage(message);
+}
+
+std::string decryptMessageRSA(const std::vector<int64_t>& encrypted, const RSAKeys& keys) {
+    return RSAKeyContext(keys).decryptMessage(encrypted);
+}
+
+std::string decryptMessageRSA(const std::vector<int64_t>& encrypted, int64_t d, int64_t n) {
+    return RSAKeyContext(RSAKeys{0, d, n}).decryptMessage(encrypted);
+}
+
+std::vector<int64_t> encryptMessageRSABlocks(const std::string& message, int64_t e, int64_t n) {
+    const uint64_t mod = static_cast<uint64_t>(n);
+    const uint64_t exp = static_cast<uint64_t>(e);
+    const size_t k = blockBytesForModulus(mod);
+    if (k == 0) {
+        throw std::invalid_argument("Модуль RSA слишком мал для блочного режима");
+    }
+
+    std::vector<int64_t> encrypted;
+    encrypted.reserve(paddedSize(message.size(), k) / k);
+    if (mod & 1) {
+        Montgomery64 mont(mod);
+        forEachPaddedBlock(message, k, [&](uint64_t m) {
+            encrypted.push_back(static_cast<int64_t>(mont.pow(m, exp)));
+        });
+    } else {
+        forEachPaddedBlock(message, k, [&](uint64_t m) {
+            encrypted.push_back(static_cast<int64_t>(powmod(m, exp, mod)));
+        });
+    }
+    return encrypted;
+}
+
+std::string decryptMessageRSABlocks(const std::vector<int64_t>& encrypted, int64_t d, int64_t n) {
+    const uint64_t mod = static_cast<uint64_t>(n);
+    const uint64_t exp = static_cast<uint64_t>(d);
+    const size_t k = blockBytesForModulus(mod);
+    if (k == 0) {
+        throw std::invalid_argument("Модуль RSA слишком мал для блочного режима");
+    }
+
+    std::string decrypted(encrypted.size() * k, '\0');
+    auto* out = reinterpret_cast<uint8_t*>(&decrypted[0]);
+    if (mod & 1) {
+        Montgomery64 mont(mod);
+        for (size_t i = 0; i < encrypted.size(); ++i) {
+            unpackBlock(mont.pow(static_cast<uint64_t>(encrypted[i]), exp), k, out + i * k);
+        }
+    } else {
+        for (size_t i = 0; i < encrypted.size(); ++i) {
+            unpackBlock(powmod(static_cast<uint64_t>(encrypted[i]), exp, mod), k, out + i * k);
         }
-        decrypted += static_cast<char>(decryptedChar);
     }
+    stripPadding(decrypted, k);
     return decrypted;
 }
+
+std::string decryptMessageRSABlocks(const std::vector<int64_t>& encrypted, const RSAKeys& keys) {
+    if (!hasCRT(keys)) {
+        return decryptMessageRSABlocks(encrypted, keys.privateKey, keys.n);
+    }
+
+    const size_t k = blockBytesForModulus(static_cast<uint64_t>(keys.n));
+    if (k == 0) {
+        throw std::invalid_argument("Модуль RSA слишком мал для блочного режима");
+    }
+
+    CRTDecryptor crt(keys);
+    std::string decrypted(encrypted.size() * k, '\0');
+    auto* out = reinterpret_cast<uint8_t*>(&decrypted[0]);
+    for (size_t i = 0; i < encrypted.size(); ++i) {
+        unpackBlock(crt(static_cast<uint64_t>(encrypted[i])), k, out + i * k);
+    }
+    stripPadding(decrypted, k);
+    return decrypted;
+}
+
+void encryptFileRSA(const std::string& inputFile, const std::string& outputFile, int64_t e, int64_t n,
+                    unsigned threads) {
+    encryptFileRSA(inputFile, outputFile, RSAKeys{e, 0, n}, RSAPrecomputed{}, threads);
+}
+
+void decryptFileRSA(const std::string& inputFile, const std::string& outputFile, const RSAKeys& keys,
+                    unsigned threads) {
+    decryptFileRSA(inputFile, outputFile, keys, RSAPrecomputed{}, threads);
+}
+
+std::unique_ptr<StreamCipher> makeRSAStreamCipher(const RSAKeys& keys, const RSAPrecomputed& pre) {
+    const uint64_t n = static_cast<uint64_t>(keys.n);
+    const ByteCodebook::Transform encrypt = encryptTransform(keys, pre);
+    const ByteCodebook::Transform decrypt = decryptTransform(keys, pre);
+    // Преобразования без состояния: потоки обработки получают копии одного объекта
+    return makeContainerStreamCipher(
+        "RSA", ContainerAlgorithm::RSA, n, blockBytesForModulus(n),
+        [encrypt] {
+            if (!encrypt) throw std::invalid_argument("Для шифрования нужен открытый ключ");
+            return encrypt;
+        },
+        [decrypt] {
+            if (!decrypt) throw std::invalid_argument("Для расшифрования нужен закрытый ключ");
+            return decrypt;
+        });
+}
+
+void encryptFileRSA(const std::string& inputFile, const std::string& outputFile, const RSAKeys& keys,
+                    const RSAPrecomputed& pre, unsigned threads) {
+    const auto cipher = makeRSAStreamCipher(RSAKeys{keys.publicKey, 0, keys.n}, pre);
+    encryptFileStream(inputFile, outputFile, *cipher, threads);
+}
+
+void decryptFileRSA(const std::string& inputFile, const std::string& outputFile, const RSAKeys& keys,
+                    const RSAPrecomputed& pre, unsigned threads) {
+    const auto cipher = makeRSAStreamCipher(keys, pre);
+    decryptFileStream(inputFile, outputFile, *cipher, threads);
+}
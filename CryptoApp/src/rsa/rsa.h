@@ -4,15 +4,119 @@
 #include <vector>
 #include <string>
 #include <cstdint>
+#include <memory>
+#include <random>
+#include "bignum.h"
+#include "modexp.h"
+#include "byte_codebook.h"
+#include "stream_cipher.h"
 
 struct RSAKeys {
     int64_t publicKey;
     int64_t privateKey;
     int64_t n;
+
+    // Параметры CRT для закрытого ключа; нули - не заданы
+    int64_t p = 0;
+    int64_t q = 0;
+    int64_t dP = 0;    // d mod (p - 1)
+    int64_t dQ = 0;    // d mod (q - 1)
+    int64_t qInv = 0;  // q^-1 mod p
+};
+
+// Константы Монтгомери ключа для модулей n, p и q (n == 0 - не заданы).
+// Вычисляются один раз при создании ключа и хранятся в файле ключа
+struct RSAPrecomputed {
+    Montgomery64::Constants n;
+    Montgomery64::Constants p;
+    Montgomery64::Constants q;
 };
 
+RSAPrecomputed precomputeRSA(const RSAKeys& keys);
+
+// Ключи RSA произвольной длины (2048, 3072, 4096 бит и т.д.)
+struct RSABigKeys {
+    BigInt publicKey;
+    BigInt privateKey;
+    BigInt n;
+    unsigned bits;
+
+    // Параметры CRT: p, q, d mod (p - 1), d mod (q - 1), q^-1 mod p
+    BigInt p;
+    BigInt q;
+    BigInt dP;
+    BigInt dQ;
+    BigInt qInv;
+};
+
+// Учебные ключи: модуль не больше 62 бит, p и q - случайные 31-битные простые
 RSAKeys generateRSAKeys();
 std::vector<int64_t> encryptMessageRSA(const std::string& message, int64_t e, int64_t n);
 std::string decryptMessageRSA(const std::vector<int64_t>& encrypted, int64_t d, int64_t n);
+// Расшифрование закрытым ключом через CRT (если параметры CRT заданы)
+std::string decryptMessageRSA(const std::vector<int64_t>& encrypted, const RSAKeys& keys);
+
+// Блочный режим: в блок упаковывается столько байт, сколько позволяет модуль
+// (7 байт для 62-битного n), сообщение дополняется по PKCS#7 (см. block_codec.h)
+std::vector<int64_t> encryptMessageRSABlocks(const std::string& message, int64_t e, int64_t n);
+std::string decryptMessageRSABlocks(const std::vector<int64_t>& encrypted, int64_t d, int64_t n);
+std::string decryptMessageRSABlocks(const std::vector<int64_t>& encrypted, const RSAKeys& keys);
+
+// Шифрование файлов в двоичный контейнер (common/cipher_container.h) блоками
+// по размеру модуля. Куски файла обрабатываются в threads потоках (0 - все ядра),
+// результат от числа потоков не зависит. Расшифрование - через CRT, если он задан.
+void encryptFileRSA(const std::string& inputFile, const std::string& outputFile, int64_t e, int64_t n,
+                    unsigned threads = 0);
+void decryptFileRSA(const std::string& inputFile, const std::string& outputFile, const RSAKeys& keys,
+                    unsigned threads = 0);
+// То же с готовыми константами Монтгомери (ключ из файла)
+void encryptFileRSA(const std::string& inputFile, const std::string& outputFile, const RSAKeys& keys,
+                    const RSAPrecomputed& pre, unsigned threads = 0);
+void decryptFileRSA(const std::string& inputFile, const std::string& outputFile, const RSAKeys& keys,
+                    const RSAPrecomputed& pre, unsigned threads = 0);
+
+// Шифр для общего файлового драйвера (common/stream_cipher.h) в формате
+// encryptFileRSA: контейнер с блоками по размеру модуля, расшифрование через
+// CRT, если он задан. Функции *FileRSA работают через него же.
+std::unique_ptr<StreamCipher> makeRSAStreamCipher(const RSAKeys& keys, const RSAPrecomputed& pre = {});
+
+// Контекст ключа для побайтового шифрования: владеет кодовой книгой,
+// так что каждое из 256 значений байта возводится в степень не более одного раза.
+// Без закрытого ключа (privateKey == 0) расшифровывает только по таблице.
+class RSAKeyContext {
+public:
+    explicit RSAKeyContext(const RSAKeys& keys);
+    RSAKeyContext(const RSAKeys& keys, const RSAPrecomputed& pre);
+
+    const RSAKeys& keys() const noexcept { return keys_; }
+
+    int64_t encryptByte(uint8_t byte) { return static_cast<int64_t>(codebook_.encrypt(byte)); }
+    char decryptWord(int64_t word) { return static_cast<char>(codebook_.decrypt(static_cast<uint64_t>(word))); }
+
+    std::vector<int64_t> encryptMessage(const std::string& message);
+    std::string decryptMessage(const std::vector<int64_t>& encrypted);
+
+    ByteCodebook::Stats codebookStats() const noexcept { return codebook_.stats(); }
+    void warmUp() { codebook_.warmUp(); }
+    // Таблица шифрования всех 256 байт (см. ByteCodebook::exportTable)
+    void exportCodebook(uint64_t* table) { codebook_.exportTable(table); }
+    void importCodebook(const uint64_t* table) { codebook_.importTable(table); }
+
+private:
+    RSAKeys keys_;
+    ByteCodebook codebook_;
+};
+
+// Простое ровно из bits бит с двумя старшими единичными битами и p - 1,
+// взаимно простым с 65537; кандидаты отбираются инкрементным решетом
+// (common/prime_sieve.h) перед тестом Миллера-Рабина
+BigInt generateBigPrime(unsigned bits, std::mt19937_64& gen);
+// Ключи с модулем ровно bits бит, e = 65537
+RSABigKeys generateRSABigKeys(unsigned bits);
+// message^e mod n; требует message < n
+BigInt encryptRSA(const BigInt& message, const RSABigKeys& keys);
+// cipher^d mod n (расшифрование или подпись). По умолчанию через CRT:
+// две экспоненты половинной длины по модулям p и q, объединяемые формулой Гарнера
+BigInt decryptRSA(const BigInt& cipher, const RSABigKeys& keys, bool useCRT = true);
 
 #endif // RSA_H
@@ -9,6 +9,8 @@
 #include <chrono>
 #include <iomanip>
 #include <numeric>
+#include <atomic>
+#include "../common/primality.h"
 
 using namespace std;
 
@@ -43,64 +45,16 @@ vector<int> sieve_of_eratosthenes(int limit = 500) {
     return primes;
 }
 
-// 2a. Оптимизированная модульная экспонентация с предварительным вычислением
+// 2a. Модульная экспонентация через 128-битное умножение (без переполнения x * x)
 uint64_t modular_pow(uint64_t base, uint64_t exponent, uint64_t mod) {
-    if (mod == 1) return 0;
-    uint64_t result = 1;
-    base %= mod;
-    while (exponent > 0) {
-        if (exponent & 1) 
-            result = (result * base) % mod;
-        exponent >>= 1;
-        base = (base * base) % mod;
-    }
-    return result;
+    return powMod64(base, exponent, mod);
 }
 
-// Тест Миллера с предварительной проверкой малых делителей
-bool miller_test(uint64_t n, const vector<int>& factors, int iterations = 5) {
-    if (n < 2) return false;
-    if (n == 2 || n == 3) return true;
-    if (n % 2 == 0) return false;
-    
-    static const int small_primes[] = {2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37};
-    for (int p : small_primes) {
-        if (n % p == 0) return n == p;
-    }
-    
-    random_device rd;
-    mt19937_64 gen(rd());
-    uniform_int_distribution<uint64_t> dis(2, n-2);
-    
-    uint64_t d = n - 1;
-    while (d % 2 == 0) d /= 2;
-    
-    for (int i = 0; i < iterations; ++i) {
-        uint64_t a = dis(gen);
-        uint64_t x = modular_pow(a, d, n);
-        
-        if (x == 1 || x == n-1) continue;
-        
-        bool composite = true;
-        uint64_t temp = d;
-        while (temp != n-1) {
-            x = (x * x) % n;
-            temp *= 2;
-            if (x == 1) {
-                miller_rejected++;
-                return false;
-            }
-            if (x == n-1) {
-                composite = false;
-                break;
-            }
-        }
-        if (composite) {
-            miller_rejected++;
-            return false;
-        }
-    }
-    return true;
+// Тест Миллера: детерминированный Миллер-Рабин для 64-битных чисел
+bool miller_test(uint64_t n, const vector<int>& /*factors*/) {
+    if (isPrime64(n)) return true;
+    miller_rejected++;
+    return false;
 }
 
 uint64_t generate_prime_miller(int target_bits, const vector<int>& primes) {
@@ -204,49 +158,11 @@ uint64_t generate_prime_poklington(int target_bits, const vector<int>& primes) {
     }
 }
 
-// 2в. Оптимизированный тест ГОСТ Р 34.10-94
-bool gost_test(uint64_t n, int iterations = 5) {
-    if (n < 2) return false;
-    if (n == 2 || n == 3) return true;
-    if (n % 2 == 0) return false;
-    
-    // Проверка малых делителей
-    static const int small_primes[] = {2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37};
-    for (int p : small_primes) {
-        if (n % p == 0) return n == p;
-    }
-    
-    uint64_t d = n - 1;
-    int s = 0;
-    while (d % 2 == 0) {
-        d /= 2;
-        s++;
-    }
-    
-    random_device rd;
-    mt19937_64 gen(rd());
-    uniform_int_distribution<uint64_t> dis(2, n-2);
-    
-    for (int i = 0; i < iterations; ++i) {
-        uint64_t a = dis(gen);
-        uint64_t x = modular_pow(a, d, n);
-        
-        if (x == 1 || x == n-1) continue;
-        
-        bool composite = true;
-        for (int j = 0; j < s-1; ++j) {
-            x = modular_pow(x, 2, n);
-            if (x == n-1) {
-                composite = false;
-                break;
-            }
-        }
-        if (composite) {
-            gost_rejected++;
-            return false;
-        }
-    }
-    return true;
+// 2в. Тест ГОСТ Р 34.10-94: та же детерминированная проверка Миллера-Рабина
+bool gost_test(uint64_t n) {
+    if (isPrime64(n)) return true;
+    gost_rejected++;
+    return false;
 }
 
 uint64_t gost_generate_prime(int target_bits) {
@@ -10,6 +10,7 @@
 #include <cmath>
 #include <bitset>
 #include <chrono>
+#include "../common/primality.h"
 
 using namespace std;
 
@@ -53,15 +54,7 @@ vector<int> sieve_of_eratosthenes() {
 
 // 2a. Тест Миллера
 uint64_t modular_pow(uint64_t base, uint64_t exponent, uint64_t mod) {
-    uint64_t result = 1;
-    base %= mod;
-    while (exponent > 0) {
-        if (exponent & 1) 
-            result = (result * base) % mod;
-        exponent >>= 1;
-        base = (base * base) % mod;
-    }
-    return result;
+    return powMod64(base, exponent, mod);
 }
 
 /**
@@ -193,40 +186,8 @@ uint64_t generate_prime_poklington(int target_bits, const vector<int>& primes) {
  */
 
 // 2в. ГОСТ Р 34.10-94 (Миниатюрная реализация)
-bool miller_rabin(uint64_t n, int k = 5) {
-    if (n < 2) return false;
-    for (int p : {2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37}) {
-        if (n % p == 0) return n == p;
-    }
-    
-    // Разложение n-1 = d*2^s
-    uint64_t d = n - 1;
-    int s = 0;
-    while (d % 2 == 0) {
-        d /= 2;
-        s++;
-    }
-    
-    random_device rd;
-    mt19937 gen(rd());
-    uniform_int_distribution<uint64_t> dis(2, n-2);
-    
-    for (int i = 0; i < k; ++i) {
-        uint64_t a = dis(gen);
-        uint64_t x = modular_pow(a, d, n);
-        if (x == 1 || x == n-1) continue;
-        
-        bool composite = true;
-        for (int j = 0; j < s-1; ++j) {
-            x = modular_pow(x, 2, n);
-            if (x == n-1) {
-                composite = false;
-                break;
-            }
-        }
-        if (composite) return false;
-    }
-    return true;
+bool miller_rabin(uint64_t n) {
+    return isPrime64(n);
 }
 
 /**
@@ -0,0 +1,261 @@
+/**
+ * @file aes_cfb_bench.cpp
+ * @brief Бенчмарк AES_CFB: размеры сообщений от 16 Б до 1 ГБ, режимы и потоки
+ *
+ * Для каждого размера (16 Б, 64 Б, 256 Б, ... с шагом 4x до --max-size) измеряются:
+ *  - encrypt/decrypt с std::string/std::vector (API с выделением результата);
+ *  - однократная сессия: новый EVP контекст на каждую операцию;
+ *  - переиспользуемый контекст объекта AES_CFB с готовым буфером;
+ *  - decrypt в 1 поток и в --threads потоков (параллельные сегменты CFB);
+ *  - stream: общий файловый драйвер (stream_cipher.h) над потоками в памяти,
+ *    с заголовком IV, в 1 и --threads потоков (до 256 МБ).
+ * Выводятся нс/оп, МБ/с и число выделений памяти на операцию (operator new
+ * и выделения OpenSSL через CRYPTO_set_mem_functions). С --json результаты
+ * пишутся в файл (или "-" - в stdout) для сравнения между версиями.
+ *
+ * Использование: aes_cfb_bench [--max-size БАЙТ] [--threads N] [--min-time С] [--json ФАЙЛ]
+ */
+
+#include "aes_cfb.h"
+#include <openssl/crypto.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+std::atomic<uint64_t> allocations{0};
+
+void* counting_malloc(size_t size, const char*, int) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    return std::malloc(size);
+}
+
+void* counting_realloc(void* ptr, size_t size, const char*, int) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    return std::realloc(ptr, size);
+}
+
+void counting_free(void* ptr, const char*, int) {
+    std::free(ptr);
+}
+
+} // namespace
+
+// Подсчёт выделений стандартной библиотеки и самой программы
+void* operator new(size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* ptr = std::malloc(size == 0 ? 1 : size)) return ptr;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept {
+    std::free(ptr);
+}
+
+namespace {
+
+struct Result {
+    std::string op;
+    std::string mode;
+    unsigned threads;
+    size_t size;
+    uint64_t iterations;
+    double ns_per_op;
+    double mb_per_s;
+    double allocs_per_op;
+};
+
+// Повторяет f не меньше min_seconds (и не меньше одного раза после прогрева)
+Result measure(const std::string& op, const std::string& mode, unsigned threads, size_t size,
+               double min_seconds, const std::function<void()>& f) {
+    f();  // прогрев: первые выделения, страницы буферов
+    const uint64_t allocs_before = allocations.load();
+    uint64_t iterations = 0;
+    const auto start = std::chrono::steady_clock::now();
+    double elapsed = 0;
+    do {
+        f();
+        ++iterations;
+        elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    } while (elapsed < min_seconds);
+    const double allocs = static_cast<double>(allocations.load() - allocs_before);
+    return {op, mode, threads, size, iterations, elapsed * 1e9 / iterations,
+            static_cast<double>(size) * iterations / elapsed / 1e6, allocs / iterations};
+}
+
+std::string size_label(size_t size) {
+    if (size >= (size_t{1} << 30)) return std::to_string(size >> 30) + " ГБ";
+    if (size >= (size_t{1} << 20)) return std::to_string(size >> 20) + " МБ";
+    if (size >= (size_t{1} << 10)) return std::to_string(size >> 10) + " КБ";
+    return std::to_string(size) + " Б";
+}
+
+void print_row(const Result& r) {
+    std::cout << "  " << std::left << std::setw(10) << r.op << std::setw(14) << r.mode << std::right
+              << std::setw(3) << r.threads << " пот. " << std::fixed << std::setprecision(1)
+              << std::setw(14) << r.ns_per_op << " нс/оп " << std::setw(10) << r.mb_per_s << " МБ/с "
+              << std::setprecision(2) << std::setw(8) << r.allocs_per_op << " выд./оп\n";
+}
+
+void write_json(std::ostream& out, const std::vector<Result>& results, unsigned threads) {
+    out << "{\n  \"benchmark\": \"aes_cfb\",\n  \"hardware_threads\": " << threads << ",\n  \"results\": [\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const Result& r = results[i];
+        out << "    {\"op\": \"" << r.op << "\", \"mode\": \"" << r.mode << "\", \"threads\": " << r.threads
+            << ", \"size\": " << r.size << ", \"iterations\": " << r.iterations << std::setprecision(6)
+            << std::defaultfloat << ", \"ns_per_op\": " << r.ns_per_op << ", \"mb_per_s\": " << r.mb_per_s
+            << ", \"allocs_per_op\": " << r.allocs_per_op << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n}\n";
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    // До первого обращения к OpenSSL: иначе подмена функций памяти не принимается
+    if (CRYPTO_set_mem_functions(counting_malloc, counting_realloc, counting_free) != 1) {
+        std::cerr << "Предупреждение: выделения OpenSSL не учитываются\n";
+    }
+
+    size_t max_size = size_t{1} << 30;
+    unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+    double min_time = 0.2;
+    std::string json_path;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            std::cerr << "Не указано значение для " << arg << "\n";
+            return 1;
+        }
+        if (arg == "--max-size") max_size = std::strtoull(argv[++i], nullptr, 10);
+        else if (arg == "--threads") threads = std::max(1u, static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10)));
+        else if (arg == "--min-time") min_time = std::strtod(argv[++i], nullptr);
+        else if (arg == "--json") json_path = argv[++i];
+        else {
+            std::cerr << "Использование: " << argv[0]
+                      << " [--max-size БАЙТ] [--threads N] [--min-time С] [--json ФАЙЛ|-]\n";
+            return 1;
+        }
+    }
+
+    try {
+        AES_CFB aes;
+        std::vector<Result> results;
+        // При выводе JSON в stdout таблица уходит в stderr
+        std::ostream& table = json_path == "-" ? std::cerr : std::cout;
+        std::streambuf* saved = std::cout.rdbuf(table.rdbuf());
+
+        std::mt19937_64 gen(2025);
+        for (size_t size = 16; size <= max_size; size *= 4) {
+            std::string plaintext(size, '\0');
+            for (auto& c : plaintext) c = static_cast<char>(gen());
+            std::vector<uint8_t> ciphertext = aes.encrypt(plaintext);
+            std::vector<uint8_t> out(size);
+            const auto* plain = reinterpret_cast<const uint8_t*>(plaintext.data());
+
+            std::cout << "Сообщение " << size_label(size) << ":\n";
+            const size_t first = results.size();
+
+            results.push_back(measure("encrypt", "api", 1, size, min_time, [&] {
+                auto c = aes.encrypt(plaintext);
+            }));
+            results.push_back(measure("encrypt", "single-shot", 1, size, min_time, [&] {
+                auto s = aes.encryptor();
+                const size_t n = s.update(plain, size, out.data());
+                s.finalize(out.data() + n);
+            }));
+            results.push_back(measure("encrypt", "reused", 1, size, min_time, [&] {
+                aes.encrypt(plain, size, out.data());
+            }));
+
+            results.push_back(measure("decrypt", "api", 1, size, min_time, [&] {
+                auto p = aes.decrypt(ciphertext, 1);
+            }));
+            results.push_back(measure("decrypt", "single-shot", 1, size, min_time, [&] {
+                auto s = aes.decryptor();
+                const size_t n = s.update(ciphertext.data(), size, out.data());
+                s.finalize(out.data() + n);
+            }));
+            results.push_back(measure("decrypt", "reused", 1, size, min_time, [&] {
+                aes.decrypt(ciphertext.data(), size, out.data(), 1);
+            }));
+            if (threads > 1) {
+                results.push_back(measure("decrypt", "reused", threads, size, min_time, [&] {
+                    aes.decrypt(ciphertext.data(), size, out.data(), threads);
+                }));
+            }
+
+            if (std::memcmp(out.data(), plain, size) != 0) {
+                std::cerr << "Ошибка: дешифрованный текст не совпадает с исходным\n";
+                return 1;
+            }
+
+            if (size <= (size_t{1} << 28)) {
+                const std::unique_ptr<StreamCipher> stream = aes.stream_cipher();
+                std::istringstream plainIn(plaintext);
+                std::ostringstream cipherOut;
+                encryptStream(plainIn, cipherOut, *stream, 1);
+                std::istringstream cipherIn(cipherOut.str());
+                std::ostringstream plainOut;
+                auto rewind = [](std::istringstream& in, std::ostringstream& out) {
+                    in.clear();
+                    in.seekg(0);
+                    out.str(std::string());
+                };
+
+                results.push_back(measure("encrypt", "stream", 1, size, min_time, [&] {
+                    rewind(plainIn, cipherOut);
+                    encryptStream(plainIn, cipherOut, *stream, 1);
+                }));
+                results.push_back(measure("decrypt", "stream", 1, size, min_time, [&] {
+                    rewind(cipherIn, plainOut);
+                    decryptStream(cipherIn, plainOut, *stream, 1);
+                }));
+                if (threads > 1) {
+                    results.push_back(measure("decrypt", "stream", threads, size, min_time, [&] {
+                        rewind(cipherIn, plainOut);
+                        decryptStream(cipherIn, plainOut, *stream, threads);
+                    }));
+                }
+                if (plainOut.str() != plaintext) {
+                    std::cerr << "Ошибка: дешифрованный через драйвер текст не совпадает с исходным\n";
+                    return 1;
+                }
+            }
+            for (size_t i = first; i < results.size(); ++i) print_row(results[i]);
+        }
+        std::cout.rdbuf(saved);
+
+        if (json_path == "-") {
+            write_json(std::cout, results, std::thread::hardware_concurrency());
+        } else if (!json_path.empty()) {
+            std::ofstream file(json_path);
+            write_json(file, results, std::thread::hardware_concurrency());
+            if (!file) {
+                std::cerr << "Ошибка записи " << json_path << "\n";
+                return 1;
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "ОШИБКА: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
@@ -6,11 +6,13 @@
 #pragma once
 
 #include <array>
+#include <memory>
 #include <vector>
 #include <string>
 #include <stdexcept>
 #include <cstdint>
 #include <openssl/evp.h>
+#include "stream_cipher.h"
 
 class AES_CFB {
 public:
@@ -19,15 +21,86 @@ public:
     using Key = std::array<uint8_t, BLOCK_SIZE>;  ///< Тип ключа (128 бит)
     using IV = std::array<uint8_t, BLOCK_SIZE>;   ///< Тип вектора инициализации
     
+    /**
+     * @brief Потоковая сессия шифрования или дешифрования с одним EVP контекстом
+     *
+     * Контекст создаётся и инициализируется ключом один раз; reset() начинает
+     * новое сообщение с другим IV без повторного выделения и расписания ключа.
+     * Данные подаются кусками любого размера через update(), поэтому большие
+     * входы обрабатываются с ограниченной памятью. В CFB выход равен входу по
+     * длине, а in и out могут совпадать (обработка на месте).
+     */
+    class Session {
+    public:
+        Session(const Key& key, const IV& iv, bool encrypt);
+        ~Session();
+
+        Session(Session&& other) noexcept;
+        Session& operator=(Session&& other) noexcept;
+        Session(const Session&) = delete;
+        Session& operator=(const Session&) = delete;
+
+        /// Начать новое сообщение с тем же ключом
+        void reset(const IV& iv);
+        /// Обработать length байт из in в out (out вмещает length байт); возвращает число записанных байт
+        size_t update(const uint8_t* in, size_t length, uint8_t* out);
+        /// Завершить сообщение; для CFB ничего не дописывает и возвращает 0
+        size_t finalize(uint8_t* out);
+
+        bool encrypting() const noexcept { return encrypt_; }
+
+    private:
+        EVP_CIPHER_CTX* ctx_;
+        bool encrypt_;
+    };
+
     AES_CFB();
     ~AES_CFB();
+
+    /// Копия получает ключ и IV; кэш сессий не копируется и создаётся заново
+    AES_CFB(const AES_CFB& other);
+    AES_CFB& operator=(const AES_CFB& other);
+    AES_CFB(AES_CFB&&) noexcept = default;
+    AES_CFB& operator=(AES_CFB&&) noexcept = default;
     
     std::vector<uint8_t> encrypt(const std::string& plaintext);
-    std::string decrypt(const std::vector<uint8_t>& ciphertext);
+    /// Шифрование length байт из in в out (out может совпадать с in)
+    void encrypt(const uint8_t* in, size_t length, uint8_t* out);
+    /// threads - число потоков для больших шифртекстов (0 - все ядра)
+    std::string decrypt(const std::vector<uint8_t>& ciphertext, unsigned threads = 0);
+
+    /**
+     * @brief Дешифрование length байт из in в out (out может совпадать с in)
+     *
+     * Блок открытого текста в CFB зависит только от двух соседних блоков
+     * шифртекста, поэтому шифртексты от PARALLEL_MIN_SEGMENT байт на поток
+     * делятся на сегменты по границам блоков. Каждый сегмент дешифруется в
+     * своём потоке со своим EVP контекстом, IV сегмента - последний блок
+     * шифртекста перед ним. Результат от числа потоков не зависит.
+     */
+    void decrypt(const uint8_t* in, size_t length, uint8_t* out, unsigned threads = 0);
+
+    static constexpr size_t PARALLEL_MIN_SEGMENT = size_t{256} << 10; ///< Минимум байт на поток
+
+    /**
+     * @brief Шифр для общего файлового драйвера (common/stream_cipher.h)
+     *
+     * Формат - как у encrypt-file: IV (16 байт), затем шифртекст. Шифрование
+     * идёт кусками по STREAM_CHUNK байт по порядку в одной сессии (чтение и
+     * запись - в своих потоках), дешифрование - кусками параллельно: IV куска
+     * берётся из последнего блока шифртекста перед ним. Ключ и IV копируются.
+     */
+    std::unique_ptr<StreamCipher> stream_cipher() const;
+
+    static constexpr size_t STREAM_CHUNK = size_t{1} << 20; ///< Кратно BLOCK_SIZE
+
+    /// Сессии с текущими ключом и IV (независимы от объекта)
+    Session encryptor() const { return Session(key_, iv_, true); }
+    Session decryptor() const { return Session(key_, iv_, false); }
     
     const Key& key() const noexcept { return key_; }
     const IV& iv() const noexcept { return iv_; }
-    void set_key(const Key& key) noexcept { key_ = key; }
+    void set_key(const Key& key);
     void set_iv(const IV& iv) noexcept { iv_ = iv; }
     
     void save_key(const std::string& filename) const;
@@ -38,6 +111,11 @@ public:
 private:
     Key key_;
     IV iv_;
+    // Сессии encrypt()/decrypt(): создаются при первом вызове и живут вместе с
+    // объектом, при смене ключа сбрасываются
+    std::unique_ptr<Session> encryptor_;
+    std::unique_ptr<Session> decryptor_;
     
     void validate() const;
+    Session& session(std::unique_ptr<Session>& cached, bool encrypt);
 };
@@ -1,9 +1,12 @@
 #include "../include/aes_cfb.h"
+#include "hex_codec.h"
 #include <openssl/rand.h>
 #include <openssl/err.h>
+#include <algorithm>
+#include <cstring>
+#include <exception>
 #include <fstream>
-#include <sstream>
-#include <iomanip>
+#include <thread>
 
 AES_CFB::AES_CFB() {
     if (RAND_bytes(key_.data(), key_.size()) != 1) {
@@ -16,6 +19,18 @@ AES_CFB::AES_CFB() {
 
 AES_CFB::~AES_CFB() {}
 
+AES_CFB::AES_CFB(const AES_CFB& other) : key_(other.key_), iv_(other.iv_) {}
+
+AES_CFB& AES_CFB::operator=(const AES_CFB& other) {
+    if (this != &other) {
+        key_ = other.key_;
+        iv_ = other.iv_;
+        encryptor_.reset();
+        decryptor_.reset();
+    }
+    return *this;
+}
+
 void AES_CFB::validate() const {
     if (key_.size() != BLOCK_SIZE) {
         throw std::invalid_argument("Неверный размер ключа");
@@ -25,84 +40,247 @@ void AES_CFB::validate() const {
     }
 }
 
-std::vector<uint8_t> AES_CFB::encrypt(const std::string& plaintext) {
-    validate();
-    
-    EVP_CIPHER_CTX* ctx = EVP_CIPHER_CTX_new();
-    if (!ctx) {
-        throw std::runtime_error("Ошибка создания контекста шифрования");
-    }
-    
-    // Инициализация контекста для шифрования
-    if (1 != EVP_EncryptInit_ex(ctx, EVP_aes_128_cfb128(), NULL, key_.data(), iv_.data())) {
-        EVP_CIPHER_CTX_free(ctx);
-        throw std::runtime_error("Ошибка инициализации шифрования");
-    }
-    
-    std::vector<uint8_t> ciphertext(plaintext.size() + BLOCK_SIZE);
-    int out_len = 0;
-    
-    // Обработка данных
-    if (1 != EVP_EncryptUpdate(ctx, ciphertext.data(), &out_len,
-                              reinterpret_cast<const uint8_t*>(plaintext.data()),
-                              static_cast<int>(plaintext.size()))) {
-        EVP_CIPHER_CTX_free(ctx);
-        throw std::runtime_error("Ошибка шифрования данных");
-    }
-    
+namespace {
+
+// EVP_CipherUpdate принимает длину как int: большие буферы подаются частями
+constexpr size_t MAX_UPDATE = size_t{1} << 30;
+
+} // namespace
+
+AES_CFB::Session::Session(const Key& key, const IV& iv, bool encrypt)
+    : ctx_(EVP_CIPHER_CTX_new()), encrypt_(encrypt) {
+    if (!ctx_) {
+        throw std::runtime_error(encrypt ? "Ошибка создания контекста шифрования"
+                                         : "Ошибка создания контекста дешифрования");
+    }
+    if (1 != EVP_CipherInit_ex(ctx_, EVP_aes_128_cfb128(), NULL, key.data(), iv.data(), encrypt ? 1 : 0)) {
+        EVP_CIPHER_CTX_free(ctx_);
+        throw std::runtime_error(encrypt ? "Ошибка инициализации шифрования"
+                                         : "Ошибка инициализации дешифрования");
+    }
+}
+
+AES_CFB::Session::~Session() {
+    EVP_CIPHER_CTX_free(ctx_);
+}
+
+AES_CFB::Session::Session(Session&& other) noexcept
+    : ctx_(other.ctx_), encrypt_(other.encrypt_) {
+    other.ctx_ = nullptr;
+}
+
+AES_CFB::Session& AES_CFB::Session::operator=(Session&& other) noexcept {
+    if (this != &other) {
+        EVP_CIPHER_CTX_free(ctx_);
+        ctx_ = other.ctx_;
+        encrypt_ = other.encrypt_;
+        other.ctx_ = nullptr;
+    }
+    return *this;
+}
+
+void AES_CFB::Session::reset(const IV& iv) {
+    // Шифр и ключ не передаются: контекст сохраняет расписание ключа
+    if (1 != EVP_CipherInit_ex(ctx_, NULL, NULL, NULL, iv.data(), encrypt_ ? 1 : 0)) {
+        throw std::runtime_error("Ошибка установки вектора инициализации");
+    }
+}
+
+size_t AES_CFB::Session::update(const uint8_t* in, size_t length, uint8_t* out) {
+    size_t written = 0;
+    while (length > 0) {
+        const size_t part = length < MAX_UPDATE ? length : MAX_UPDATE;
+        int out_len = 0;
+        if (1 != EVP_CipherUpdate(ctx_, out + written, &out_len, in, static_cast<int>(part))) {
+            throw std::runtime_error(encrypt_ ? "Ошибка шифрования данных" : "Ошибка дешифрования данных");
+        }
+        written += static_cast<size_t>(out_len);
+        in += part;
+        length -= part;
+    }
+    return written;
+}
+
+size_t AES_CFB::Session::finalize(uint8_t* out) {
     int final_len = 0;
-    if (1 != EVP_EncryptFinal_ex(ctx, ciphertext.data() + out_len, &final_len)) {
-        EVP_CIPHER_CTX_free(ctx);
-        throw std::runtime_error("Ошибка финализации шифрования");
+    if (1 != EVP_CipherFinal_ex(ctx_, out, &final_len)) {
+        throw std::runtime_error(encrypt_ ? "Ошибка финализации шифрования" : "Ошибка финализации дешифрования");
+    }
+    return static_cast<size_t>(final_len);
+}
+
+void AES_CFB::set_key(const Key& key) {
+    key_ = key;
+    encryptor_.reset();
+    decryptor_.reset();
+}
+
+// Сессия объекта: контекст создаётся один раз, на каждое сообщение меняется только IV
+AES_CFB::Session& AES_CFB::session(std::unique_ptr<Session>& cached, bool encrypt) {
+    if (!cached) {
+        cached = std::make_unique<Session>(key_, iv_, encrypt);
+    } else {
+        cached->reset(iv_);
     }
-    
-    ciphertext.resize(out_len + final_len);
-    EVP_CIPHER_CTX_free(ctx);
+    return *cached;
+}
+
+std::vector<uint8_t> AES_CFB::encrypt(const std::string& plaintext) {
+    // CFB - потоковый режим: шифртекст той же длины, что и открытый текст
+    std::vector<uint8_t> ciphertext(plaintext.size());
+    encrypt(reinterpret_cast<const uint8_t*>(plaintext.data()), plaintext.size(), ciphertext.data());
     return ciphertext;
 }
 
-std::string AES_CFB::decrypt(const std::vector<uint8_t>& ciphertext) {
+void AES_CFB::encrypt(const uint8_t* in, size_t length, uint8_t* out) {
     validate();
-    
-    EVP_CIPHER_CTX* ctx = EVP_CIPHER_CTX_new();
-    if (!ctx) {
-        throw std::runtime_error("Ошибка создания контекста дешифрования");
-    }
-    
-    // Инициализация контекста для дешифрования
-    if (1 != EVP_DecryptInit_ex(ctx, EVP_aes_128_cfb128(), NULL, key_.data(), iv_.data())) {
-        EVP_CIPHER_CTX_free(ctx);
-        throw std::runtime_error("Ошибка инициализации дешифрования");
-    }
-    
+    Session& s = session(encryptor_, true);
+    const size_t written = s.update(in, length, out);
+    s.finalize(out + written);
+}
+
+std::string AES_CFB::decrypt(const std::vector<uint8_t>& ciphertext, unsigned threads) {
     std::string plaintext(ciphertext.size(), '\0');
-    int out_len = 0;
-    
-    // Обработка данных
-    if (1 != EVP_DecryptUpdate(ctx, reinterpret_cast<uint8_t*>(&plaintext[0]), &out_len,
-                              ciphertext.data(), static_cast<int>(ciphertext.size()))) {
-        EVP_CIPHER_CTX_free(ctx);
-        throw std::runtime_error("Ошибка дешифрования данных");
-    }
-    
-    int final_len = 0;
-    if (1 != EVP_DecryptFinal_ex(ctx, reinterpret_cast<uint8_t*>(&plaintext[0]) + out_len, &final_len)) {
-        EVP_CIPHER_CTX_free(ctx);
-        throw std::runtime_error("Ошибка финализации дешифрования");
-    }
-    
-    plaintext.resize(out_len + final_len);
-    EVP_CIPHER_CTX_free(ctx);
+    decrypt(ciphertext.data(), ciphertext.size(), reinterpret_cast<uint8_t*>(&plaintext[0]), threads);
     return plaintext;
 }
 
-std::string AES_CFB::bytes_to_hex(const uint8_t* data, size_t length) {
-    std::ostringstream oss;
-    oss << std::hex << std::setfill('0');
-    for (size_t i = 0; i < length; ++i) {
-        oss << std::setw(2) << static_cast<int>(data[i]);
+void AES_CFB::decrypt(const uint8_t* in, size_t length, uint8_t* out, unsigned threads) {
+    validate();
+
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    const size_t parts = std::min<size_t>(threads, std::max<size_t>(1, length / PARALLEL_MIN_SEGMENT));
+    if (parts == 1) {
+        Session& s = session(decryptor_, false);
+        const size_t written = s.update(in, length, out);
+        s.finalize(out + written);
+        return;
+    }
+
+    // Сегменты по целому числу блоков; IV сегментов берутся до запуска потоков,
+    // чтобы дешифрование на месте не затёрло их раньше времени
+    const size_t blocks = (length + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    const size_t segment = (blocks + parts - 1) / parts * BLOCK_SIZE;
+    std::vector<IV> ivs(parts, iv_);
+    for (size_t p = 1; p < parts; ++p) {
+        std::copy(in + p * segment - BLOCK_SIZE, in + p * segment, ivs[p].begin());
+    }
+
+    std::vector<std::exception_ptr> errors(parts);
+    auto run = [&](size_t p) {
+        try {
+            const size_t begin = p * segment;
+            const size_t size = std::min(length, begin + segment) - begin;
+            Session s(key_, ivs[p], false);
+            const size_t written = s.update(in + begin, size, out + begin);
+            s.finalize(out + begin + written);
+        } catch (...) {
+            errors[p] = std::current_exception();
+        }
+    };
+
+    std::vector<std::thread> workers;
+    workers.reserve(parts - 1);
+    for (size_t p = 1; p < parts; ++p) {
+        workers.emplace_back(run, p);
+    }
+    run(0);
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    for (const auto& error : errors) {
+        if (error) std::rethrow_exception(error);
+    }
+}
+
+namespace {
+
+/// Шифрование CFB: каждый кусок продолжает обратную связь предыдущего
+class CfbEncryptTransform : public BlockTransform {
+public:
+    CfbEncryptTransform(const AES_CFB::Key& key, const AES_CFB::IV& iv) : session_(key, iv, true) {}
+
+    size_t chunkSize() const override { return AES_CFB::STREAM_CHUNK; }
+    size_t maxOutputSize(size_t size) const override { return size; }
+
+    size_t process(uint64_t, const uint8_t* in, size_t size, uint8_t* out) override {
+        return session_.update(in, size, out);
     }
-    return oss.str();
+
+    bool independentChunks() const override { return false; }
+    std::unique_ptr<BlockTransform> clone() const override { return nullptr; }
+
+    void finish(uint64_t) override {
+        uint8_t tail[AES_CFB::BLOCK_SIZE];
+        session_.finalize(tail);
+    }
+
+private:
+    AES_CFB::Session session_;
+};
+
+/// Дешифрование CFB: кусок зависит только от своего шифртекста и блока перед ним
+class CfbDecryptTransform : public BlockTransform {
+public:
+    CfbDecryptTransform(const AES_CFB::Key& key, const AES_CFB::IV& iv)
+        : key_(key), iv_(iv), session_(key, iv, false) {}
+
+    size_t chunkSize() const override { return AES_CFB::STREAM_CHUNK; }
+    size_t maxOutputSize(size_t size) const override { return size; }
+    size_t historySize() const override { return AES_CFB::BLOCK_SIZE; }
+
+    size_t process(uint64_t offset, const uint8_t* in, size_t size, uint8_t* out) override {
+        AES_CFB::IV iv = iv_;
+        if (offset > 0) std::memcpy(iv.data(), in - AES_CFB::BLOCK_SIZE, AES_CFB::BLOCK_SIZE);
+        session_.reset(iv);
+        return session_.update(in, size, out);
+    }
+
+    std::unique_ptr<BlockTransform> clone() const override {
+        return std::unique_ptr<BlockTransform>(new CfbDecryptTransform(key_, iv_));
+    }
+
+private:
+    AES_CFB::Key key_;
+    AES_CFB::IV iv_;
+    AES_CFB::Session session_;
+};
+
+class CfbStreamCipher : public StreamCipher {
+public:
+    CfbStreamCipher(const AES_CFB::Key& key, const AES_CFB::IV& iv) : key_(key), iv_(iv) {}
+
+    const char* name() const override { return "AES-128 CFB"; }
+
+    std::unique_ptr<BlockTransform> encryptor(std::ostream& out, uint64_t) override {
+        out.write(reinterpret_cast<const char*>(iv_.data()), AES_CFB::BLOCK_SIZE);
+        return std::unique_ptr<BlockTransform>(new CfbEncryptTransform(key_, iv_));
+    }
+
+    std::unique_ptr<BlockTransform> decryptor(std::istream& in) override {
+        AES_CFB::IV iv;
+        if (!in.read(reinterpret_cast<char*>(iv.data()), AES_CFB::BLOCK_SIZE)) {
+            throw std::runtime_error("Файл слишком короткий: нет вектора инициализации");
+        }
+        return std::unique_ptr<BlockTransform>(new CfbDecryptTransform(key_, iv));
+    }
+
+private:
+    AES_CFB::Key key_;
+    AES_CFB::IV iv_;
+};
+
+} // namespace
+
+std::unique_ptr<StreamCipher> AES_CFB::stream_cipher() const {
+    validate();
+    return std::unique_ptr<StreamCipher>(new CfbStreamCipher(key_, iv_));
+}
+
+std::string AES_CFB::bytes_to_hex(const uint8_t* data, size_t length) {
+    return hexEncode(data, length);
 }
 
 void AES_CFB::save_key(const std::string& filename) const {
@@ -119,4 +297,6 @@ void AES_CFB::load_key(const std::string& filename) {
         throw std::runtime_error("Ошибка открытия файла ключа для чтения");
     }
     file.read(reinterpret_cast<char*>(key_.data()), key_.size());
+    encryptor_.reset();
+    decryptor_.reset();
 }
@@ -0,0 +1,138 @@
+/**
+ * Бенчмарк расширенного алгоритма Евклида.
+ *
+ * На одних и тех же случайных парах сравниваются прежняя рекурсивная версия
+ * (кортеж на каждый уровень), итеративный extendedGcd и бинарный
+ * extendedGcdBinary для 32-, 64- и 128-битных чисел. Для 64 бит числа берутся
+ * до 2^61, чтобы бинарный вариант работал на тех же входах. Каждый результат
+ * проверяется по тождеству a * x + b * y = gcd.
+ *
+ * Использование: bench_euclid [число пар, по умолчанию 1000000]
+ */
+
+#include "euclid.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+
+using namespace std;
+
+namespace {
+
+#ifdef __SIZEOF_INT128__
+// __extension__: без предупреждения -Wpedantic (как в common/modmul.h)
+__extension__ typedef __int128 int128;
+__extension__ typedef unsigned __int128 uint128;
+#endif
+
+// Прежняя реализация extendEuclid, обобщённая на int64_t: рекурсия и кортеж на уровень
+tuple<int64_t, int64_t, int64_t> extendEuclidRecursive(int64_t a, int64_t b) {
+    if (b == 0) {
+        return make_tuple(a, 1, 0);
+    }
+    auto [g, x1, y1] = extendEuclidRecursive(b, a % b);
+    return make_tuple(g, y1, x1 - (a / b) * y1);
+}
+
+template <typename T>
+struct Pair {
+    T a;
+    T b;
+};
+
+template <typename T>
+vector<Pair<T>> randomPairs(size_t count, unsigned bits, mt19937_64& gen) {
+    vector<Pair<T>> pairs(count);
+    for (auto& p : pairs) {
+        T a = static_cast<T>(gen()), b = static_cast<T>(gen());
+        if constexpr (sizeof(T) > 8) {
+            for (unsigned done = 64; done < bits; done += 64) {
+                a = (a << 64) | static_cast<T>(gen());
+                b = (b << 64) | static_cast<T>(gen());
+            }
+        }
+        const T mask = (static_cast<T>(1) << (bits - 1) << 1) - 1;
+        p = {a & mask, b & mask};
+    }
+    return pairs;
+}
+
+// Ширина в символах для UTF-8 (setw считает байты)
+size_t displayWidth(const string& s) {
+    size_t width = 0;
+    for (unsigned char c : s) width += (c & 0xc0) != 0x80;
+    return width;
+}
+
+// Время на пару в нс; f(a, b) возвращает ExtendedGcd или кортеж, проверка через
+// check выполняется после замера
+template <typename T, typename F, typename Check>
+void run(const string& name, const vector<Pair<T>>& pairs, F f, Check check) {
+    using R = decltype(f(T{}, T{}));
+    vector<R> results;
+    results.reserve(pairs.size());
+    const auto start = chrono::steady_clock::now();
+    for (const auto& p : pairs) results.push_back(f(p.a, p.b));
+    const double ns = chrono::duration<double>(chrono::steady_clock::now() - start).count() * 1e9 / pairs.size();
+
+    bool ok = true;
+    for (size_t i = 0; i < pairs.size() && ok; ++i) ok = check(pairs[i].a, pairs[i].b, results[i]);
+    cout << "  " << name << string(34 - min<size_t>(34, displayWidth(name)), ' ') << setw(8) << ns << " нс"
+         << (ok ? "" : "  ОШИБКА") << endl;
+    if (!ok) exit(1);
+}
+
+template <typename T>
+tuple<T, T, T> asTuple(const ExtendedGcd<T>& r) {
+    return make_tuple(r.gcd, r.x, r.y);
+}
+
+// a * x + b * y == gcd (для 128 бит - по модулю 2^128)
+template <typename T>
+bool bezout(T a, T b, const tuple<T, T, T>& r) {
+#ifdef __SIZEOF_INT128__
+    using Wide = uint128;
+#else
+    using Wide = uint64_t;
+#endif
+    return static_cast<Wide>(a) * static_cast<Wide>(get<1>(r)) + static_cast<Wide>(b) * static_cast<Wide>(get<2>(r)) ==
+           static_cast<Wide>(get<0>(r));
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const size_t count = argc > 1 ? strtoul(argv[1], nullptr, 10) : 1000000;
+    mt19937_64 gen(2025);
+    cout << fixed << setprecision(1);
+
+    const auto p64 = randomPairs<int64_t>(count, 61, gen);
+    cout << "64 бит (" << count << " пар до 2^61):" << endl;
+    run("рекурсивный (прежний)", p64, extendEuclidRecursive, bezout<int64_t>);
+    run("extendedGcd<int64_t>", p64, [](int64_t a, int64_t b) { return asTuple(extendedGcd(a, b)); }, bezout<int64_t>);
+    run("extendedGcdBinary<int64_t>", p64, [](int64_t a, int64_t b) { return asTuple(extendedGcdBinary(a, b)); },
+        bezout<int64_t>);
+
+    const auto p32 = randomPairs<int32_t>(count, 29, gen);
+    cout << "32 бита (до 2^29):" << endl;
+    run("extendedGcd<int32_t>", p32, [](int32_t a, int32_t b) { return asTuple(extendedGcd(a, b)); }, bezout<int32_t>);
+    run("extendedGcdBinary<int32_t>", p32, [](int32_t a, int32_t b) { return asTuple(extendedGcdBinary(a, b)); },
+        bezout<int32_t>);
+
+#ifdef __SIZEOF_INT128__
+    const auto p128 = randomPairs<int128>(count / 4, 125, gen);
+    cout << "128 бит (" << count / 4 << " пар до 2^125):" << endl;
+    run("extendedGcd<__int128>", p128, [](int128 a, int128 b) { return asTuple(extendedGcd(a, b)); },
+        bezout<int128>);
+    run("extendedGcdBinary<__int128>", p128, [](int128 a, int128 b) { return asTuple(extendedGcdBinary(a, b)); },
+        bezout<int128>);
+#endif
+    return 0;
+}
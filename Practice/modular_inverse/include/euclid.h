@@ -1,6 +1,8 @@
 #ifndef EUCLID_H
 #define EUCLID_H
 
+#include <limits>
+#include <stdexcept>
 #include <tuple>
 
 // Функция для вычисления НОД
@@ -15,4 +17,134 @@ int modInverseEuclid(int a, int m);
 // Расширенный алгоритм Евклида, возвращающий только коэффициенты
 std::tuple<int, int> extended_gcd(int a, int b);
 
+/**
+ * Результат расширенного алгоритма Евклида: a * x + b * y = gcd.
+ */
+template <typename T>
+struct ExtendedGcd {
+    T gcd;
+    T x;
+    T y;
+};
+
+/**
+ * Итеративный расширенный алгоритм Евклида для знаковых целых
+ * (int32_t, int64_t, __int128): без рекурсии и без промежуточных кортежей.
+ * Даёт те же коэффициенты, что и рекурсивный extendEuclid; при a, b >= 0
+ * |x| <= b / gcd и |y| <= a / gcd, поэтому переполнения нет на всём диапазоне T.
+ * @param a Первое число.
+ * @param b Второе число.
+ * @return НОД и коэффициенты Безу.
+ */
+template <typename T>
+ExtendedGcd<T> extendedGcd(T a, T b) {
+    T x0 = 1, x1 = 0, y0 = 0, y1 = 1;
+    while (b != 0) {
+        const T q = a / b;
+        T t = a - q * b;
+        a = b;
+        b = t;
+        t = x0 - q * x1;
+        x0 = x1;
+        x1 = t;
+        t = y0 - q * y1;
+        y0 = y1;
+        y1 = t;
+    }
+    return {a, x0, y0};
+}
+
+/**
+ * Бинарный расширенный алгоритм (Штейн): вместо деления - сдвиги и вычитания.
+ * Коэффициенты держатся в пределах |A|, |C| < b и |B|, |D| <= 2a, но
+ * промежуточные суммы вдвое больше, поэтому a и b должны быть неотрицательны
+ * и не больше max(T) / 4 (для int64_t - около 2^61).
+ * Коэффициенты Безу могут отличаться от extendedGcd (они не единственны).
+ * @param a Первое число.
+ * @param b Второе число.
+ * @return НОД и коэффициенты Безу.
+ * @throws invalid_argument Если a или b вне допустимого диапазона.
+ */
+template <typename T>
+ExtendedGcd<T> extendedGcdBinary(T a, T b) {
+    if (a < 0 || b < 0 || a > std::numeric_limits<T>::max() / 4 || b > std::numeric_limits<T>::max() / 4) {
+        throw std::invalid_argument("Числа для бинарного алгоритма должны быть от 0 до max / 4");
+    }
+    if (a == 0) return {b, 0, 1};
+    if (b == 0) return {a, 1, 0};
+
+    // Общая степень двойки выносится в множитель НОД
+    int shift = 0;
+    while (((a | b) & 1) == 0) {
+        a >>= 1;
+        b >>= 1;
+        ++shift;
+    }
+
+    // Инварианты: A * a + B * b = u, C * a + D * b = v
+    T u = a, v = b, A = 1, B = 0, C = 0, D = 1;
+    while (u != 0) {
+        while ((u & 1) == 0) {
+            u >>= 1;
+            // Делимые чётны, поэтому деление на 2 точное и для отрицательных
+            if (((A | B) & 1) == 0) {
+                A /= 2;
+                B /= 2;
+            } else {
+                A = (A + b) / 2;
+                B = (B - a) / 2;
+            }
+        }
+        while ((v & 1) == 0) {
+            v >>= 1;
+            if (((C | D) & 1) == 0) {
+                C /= 2;
+                D /= 2;
+            } else {
+                C = (C + b) / 2;
+                D = (D - a) / 2;
+            }
+        }
+        // Приведение A, C в [0, b) сохраняет инварианты (+b * a - a * b = 0)
+        // и не даёт коэффициентам расти
+        if (u >= v) {
+            u -= v;
+            A -= C;
+            B -= D;
+            if (A < 0) {
+                A += b;
+                B -= a;
+            }
+        } else {
+            v -= u;
+            C -= A;
+            D -= B;
+            if (C < 0) {
+                C += b;
+                D -= a;
+            }
+        }
+    }
+    return {v << shift, C, D};
+}
+
+/**
+ * Обратный элемент по модулю m через extendedGcd.
+ * @throws invalid_argument Если модуль не положительный.
+ * @throws runtime_error Если обратный элемент не существует.
+ */
+template <typename T>
+T modInverse(T a, T m) {
+    if (m <= 0) {
+        throw std::invalid_argument("Модуль должен быть положительным");
+    }
+    a %= m;
+    if (a < 0) a += m;
+    const ExtendedGcd<T> r = extendedGcd(a, m);
+    if (r.gcd != 1) {
+        throw std::runtime_error("Обратный элемент не существует");
+    }
+    return r.x < 0 ? r.x + m : r.x;
+}
+
 #endif // EUCLID_H
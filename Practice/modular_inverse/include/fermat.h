@@ -4,11 +4,11 @@
 #include <cstdint> // Для int64_t
 
 /**
- * Проверяет, является ли число простым.
+ * Проверяет, является ли число простым (детерминированный тест Миллера-Рабина).
  * @param n Число для проверки.
  * @return true, если число простое, иначе false.
  */
-bool is_prime(int n);
+bool is_prime(int64_t n);
 
 /**
  * Вычисляет base^exponent mod mod.
@@ -1,7 +1,21 @@
 #ifndef MODULAR_INVERSE_H
 #define MODULAR_INVERSE_H
 
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
 // Базовый метод вычисления обратного элемента
 int modularInverse(int v, int c);
 
-#endif
\ No newline at end of file
+// Пакетное обращение (трюк Монтгомери): обратные ко всем values по модулю m
+// за одно обращение расширенным алгоритмом Евклида и 3(N-1) умножений.
+// Все элементы должны быть обратимы; out может совпадать с values.
+void batchModularInverse(const int64_t* values, size_t count, int64_t m, int64_t* out);
+std::vector<int64_t> batchModularInverse(const std::vector<int64_t>& values, int64_t m);
+
+// Таблица обратных inv[i] = i^-1 mod p для i = 1..p-1 (inv[0] = 0) за O(p),
+// p - простое число меньше 2^31; элементы меньше p, поэтому 32-битные
+std::vector<uint32_t> inverseTable(int64_t p);
+
+#endif
@@ -8,6 +8,13 @@ struct RSAKeys {
     int64_t publicKey;
     int64_t privateKey;
     int64_t n;
+
+    // Параметры CRT для закрытого ключа
+    int64_t p;
+    int64_t q;
+    int64_t dP;    // d mod (p - 1)
+    int64_t dQ;    // d mod (q - 1)
+    int64_t qInv;  // q^-1 mod p
 };
 
 // Основная функция для запуска RSA-шифрования
@@ -38,15 +38,8 @@ int gcd(int a, int b) {
  * @return Кортеж (НОД, x, y), где x и y - коэффициенты.
  */
 tuple<int, int, int> extendEuclid(int a, int b) {
-    if (b == 0) {
-        return make_tuple(a, 1, 0);
-    }
-
-    auto [gcd, x1, y1] = extendEuclid(b, a % b);
-    int x = y1;
-    int y = x1 - (a / b) * y1;
-
-    return make_tuple(gcd, x, y);
+    const ExtendedGcd<int> r = extendedGcd(a, b);
+    return make_tuple(r.gcd, r.x, r.y);
 }
 
 /**
@@ -56,12 +49,8 @@ tuple<int, int, int> extendEuclid(int a, int b) {
  * @return Кортеж (x, y), где x и y - коэффициенты.
  */
 tuple<int, int> extended_gcd(int a, int b) {
-    if (b == 0) {
-        return make_tuple(1, 0);
-    } else {
-        auto [x, y] = extended_gcd(b, a % b);
-        return make_tuple(y, x - (a / b) * y);
-    }
+    const ExtendedGcd<int> r = extendedGcd(a, b);
+    return make_tuple(r.x, r.y);
 }
 
 /**
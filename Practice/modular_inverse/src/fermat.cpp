@@ -1,25 +1,15 @@
 #include "fermat.h"
-#include <cmath>
+#include "primality.h"
 #include <stdexcept>
 #include <cstdint> // Для int64_t
 
 /**
- * Проверяет, является ли число простым.
+ * Проверяет, является ли число простым (детерминированный тест Миллера-Рабина).
  * @param n Число для проверки.
  * @return true, если число простое, иначе false.
  */
-bool is_prime(int n) {
-    if (n <= 1) return false;
-    if (n == 2) return true;
-    if (n % 2 == 0) return false;
-    
-    int limit = static_cast<int>(std::sqrt(n)) + 1;
-    for (int i = 3; i <= limit; i += 2) {
-        if (n % i == 0) {
-            return false;
-        }
-    }
-    return true;
+bool is_prime(int64_t n) {
+    return n > 1 && isPrime64(static_cast<uint64_t>(n));
 }
 
 /**
@@ -31,20 +21,14 @@ bool is_prime(int n) {
  */
 int64_t mod_exp(int64_t base, int64_t exponent, int64_t mod) {
     if (mod == 1) return 0;
+    if (exponent <= 0) return 1;
     
-    int64_t result = 1;
     base = base % mod;
+    if (base < 0) base += mod;
     
-    while (exponent > 0) {
-        if (exponent % 2 == 1) {
-            result = (result * base) % mod;
-        }
-        
-        exponent = exponent >> 1;
-        base = (base * base) % mod;
-    }
-    
-    return result;
+    // Умножение через 128 бит: без переполнения для любого модуля до 2^63
+    return static_cast<int64_t>(powMod64(static_cast<uint64_t>(base), static_cast<uint64_t>(exponent),
+                                         static_cast<uint64_t>(mod)));
 }
 
 /**
@@ -1,5 +1,9 @@
 #include "modular_inverse.h"
+#include "euclid.h"
+#include "fermat.h"
+#include "modmul.h"
 #include <stdexcept>
+#include <string>
 
 /**
  * Находит обратный элемент по модулю методом перебора.
@@ -26,4 +30,95 @@ int modularInverse(int v, int c) {
     }
     
     throw std::runtime_error("Обратный элемент не существует");
-}
\ No newline at end of file
+}
+
+namespace {
+
+int64_t normalize(int64_t a, int64_t m) {
+    a %= m;
+    return a < 0 ? a + m : a;
+}
+
+// Обратный элемент расширенным алгоритмом Евклида; 0, если не существует
+int64_t inverseOrZero(int64_t a, int64_t m) {
+    const ExtendedGcd<int64_t> r = extendedGcd(a, m);
+    return r.gcd == 1 ? normalize(r.x, m) : 0;
+}
+
+} // namespace
+
+/**
+ * Пакетное обращение по модулю (трюк Монтгомери).
+ * prefix[i] = v0 * ... * vi; обратный к произведению всех элементов вычисляется
+ * один раз, затем проходом с конца inv(vi) = inv(prefix[i]) * prefix[i-1] и
+ * inv(prefix[i-1]) = inv(prefix[i]) * vi.
+ * @param values Числа для обращения.
+ * @param count Количество чисел.
+ * @param m Модуль (m > 1).
+ * @param out Результат, count элементов.
+ * @throws invalid_argument Если модуль меньше 2.
+ * @throws runtime_error Если обратный элемент к одному из чисел не существует.
+ */
+void batchModularInverse(const int64_t* values, size_t count, int64_t m, int64_t* out) {
+    if (m < 2) {
+        throw std::invalid_argument("Модуль должен быть больше 1");
+    }
+    if (count == 0) return;
+
+    const uint64_t mod = static_cast<uint64_t>(m);
+    std::vector<uint64_t> prefix(count);
+    uint64_t product = 1;
+    for (size_t i = 0; i < count; ++i) {
+        product = mulMod64(product, static_cast<uint64_t>(normalize(values[i], m)), mod);
+        prefix[i] = product;
+    }
+
+    uint64_t inverse = static_cast<uint64_t>(inverseOrZero(static_cast<int64_t>(product), m));
+    if (inverse == 0) {
+        // Произведение необратимо: находим первый виновный элемент для сообщения
+        for (size_t i = 0; i < count; ++i) {
+            if (inverseOrZero(normalize(values[i], m), m) == 0) {
+                throw std::runtime_error("Обратный элемент не существует для элемента " + std::to_string(i));
+            }
+        }
+        throw std::runtime_error("Обратный элемент не существует");
+    }
+
+    for (size_t i = count; i-- > 1;) {
+        const uint64_t v = static_cast<uint64_t>(normalize(values[i], m));  // до записи out[i]: out может быть values
+        out[i] = static_cast<int64_t>(mulMod64(inverse, prefix[i - 1], mod));
+        inverse = mulMod64(inverse, v, mod);
+    }
+    out[0] = static_cast<int64_t>(inverse);
+}
+
+std::vector<int64_t> batchModularInverse(const std::vector<int64_t>& values, int64_t m) {
+    std::vector<int64_t> out(values.size());
+    batchModularInverse(values.data(), values.size(), m, out.data());
+    return out;
+}
+
+/**
+ * Таблица всех обратных по простому модулю за O(p).
+ * p = (p / i) * i + p % i, откуда i^-1 = -(p / i) * (p % i)^-1 mod p,
+ * а p % i < i уже вычислен.
+ * Элементы меньше p < 2^31 и хранятся как uint32_t: таблица вдвое меньше
+ * (до 8 ГиБ вместо 16 при наибольшем p).
+ * @param p Простой модуль, 2 <= p < 2^31.
+ * @return Вектор длины p, inv[i] * i mod p = 1 для i >= 1.
+ * @throws invalid_argument Если p не простое или не меньше 2^31.
+ */
+std::vector<uint32_t> inverseTable(int64_t p) {
+    if (p < 2 || p > INT32_MAX || !is_prime(p)) {
+        throw std::invalid_argument("Модуль должен быть простым числом меньше 2^31");
+    }
+    const uint64_t mod = static_cast<uint64_t>(p);
+    std::vector<uint32_t> inv(static_cast<size_t>(p));
+    inv[1] = 1;
+    for (uint64_t i = 2; i < mod; ++i) {
+        // (p / i) * inv < p^2 < 2^62
+        const uint64_t t = mod / i * inv[mod % i] % mod;
+        inv[i] = static_cast<uint32_t>(t == 0 ? 0 : mod - t);
+    }
+    return inv;
+}
@@ -0,0 +1,83 @@
+#ifndef BLOCK_CODEC_H
+#define BLOCK_CODEC_H
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
+// Упаковка байтов открытого текста в блоки для RSA/LUC с небольшим модулем.
+//
+// В блок помещается k байт, где k - наибольшее число с 256^k <= n, поэтому
+// значение блока (big-endian) всегда меньше модуля. Сообщение дополняется
+// по схеме PKCS#7: добавляется от 1 до k байт, каждый равен числу добавленных
+// байт, так что длина становится кратной k и дополнение всегда однозначно.
+
+// Число байт открытого текста в блоке для модуля n (0, если n < 256)
+inline size_t blockBytesForModulus(uint64_t n) {
+    size_t k = 0;
+    while (k < 7 && (n >> (8 * (k + 1))) != 0) ++k;
+    return k;
+}
+
+// Длина сообщения после дополнения
+inline size_t paddedSize(size_t size, size_t blockBytes) {
+    return (size / blockBytes + 1) * blockBytes;
+}
+
+// Значение блока из blockBytes байт (big-endian)
+inline uint64_t packBlock(const uint8_t* data, size_t blockBytes) {
+    uint64_t value = 0;
+    for (size_t i = 0; i < blockBytes; ++i) {
+        value = (value << 8) | data[i];
+    }
+    return value;
+}
+
+inline void unpackBlock(uint64_t value, size_t blockBytes, uint8_t* out) {
+    for (size_t i = blockBytes; i-- > 0;) {
+        out[i] = static_cast<uint8_t>(value);
+        value >>= 8;
+    }
+}
+
+// Вызывает f(value) для каждого блока сообщения с дополнением PKCS#7
+template <typename F>
+void forEachPaddedBlock(const std::string& message, size_t blockBytes, F f) {
+    if (blockBytes == 0) {
+        throw std::invalid_argument("Модуль слишком мал для блочного режима");
+    }
+    const auto* data = reinterpret_cast<const uint8_t*>(message.data());
+    const size_t full = message.size() / blockBytes * blockBytes;
+    for (size_t i = 0; i < full; i += blockBytes) {
+        f(packBlock(data + i, blockBytes));
+    }
+
+    // Последний блок: остаток сообщения и байты дополнения
+    uint8_t tail[8];
+    const size_t rest = message.size() - full;
+    const uint8_t pad = static_cast<uint8_t>(blockBytes - rest);
+    for (size_t i = 0; i < blockBytes; ++i) {
+        tail[i] = i < rest ? data[full + i] : pad;
+    }
+    f(packBlock(tail, blockBytes));
+}
+
+// Снимает дополнение PKCS#7 с расшифрованного текста
+inline void stripPadding(std::string& text, size_t blockBytes) {
+    if (text.empty() || text.size() % blockBytes != 0) {
+        throw std::runtime_error("Некорректная длина блочного шифртекста");
+    }
+    const size_t pad = static_cast<uint8_t>(text.back());
+    if (pad == 0 || pad > blockBytes) {
+        throw std::runtime_error("Некорректное дополнение блока");
+    }
+    for (size_t i = text.size() - pad; i < text.size(); ++i) {
+        if (static_cast<uint8_t>(text[i]) != pad) {
+            throw std::runtime_error("Некорректное дополнение блока");
+        }
+    }
+    text.resize(text.size() - pad);
+}
+
+#endif // BLOCK_CODEC_H
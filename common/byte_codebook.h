@@ -0,0 +1,126 @@
+#ifndef BYTE_CODEBOOK_H
+#define BYTE_CODEBOOK_H
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
+#include <unordered_map>
+
+// Кодовая книга побайтового шифрования для ключей с небольшим модулем.
+//
+// При побайтовом RSA/LUC открытый текст принимает всего 256 значений, поэтому
+// результаты шифрования запоминаются в таблице из 256 элементов, а для
+// расшифрования ведётся обратная хеш-таблица. Таблица заполняется лениво:
+// промах вычисляет преобразование, попадание стоит одного обращения к памяти.
+//
+// Класс не потокобезопасен: для параллельной обработки заполните таблицу
+// заранее вызовом warmUp() и используйте отдельный экземпляр на поток.
+class ByteCodebook {
+public:
+    using Transform = std::function<uint64_t(uint64_t)>;
+
+    struct Stats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+    };
+
+    // encrypt - операция открытым ключом, decrypt - закрытым (может быть пустой)
+    ByteCodebook(Transform encrypt, Transform decrypt)
+        : encrypt_(std::move(encrypt)), decrypt_(std::move(decrypt)) {
+        known_.fill(false);
+        reverse_.reserve(512);
+    }
+
+    uint64_t encrypt(uint8_t byte) {
+        if (known_[byte]) {
+            ++stats_.hits;
+            return table_[byte];
+        }
+        ++stats_.misses;
+        return remember(byte, encrypt_(byte));
+    }
+
+    uint8_t decrypt(uint64_t cipher) {
+        auto it = reverse_.find(cipher);
+        if (it != reverse_.end()) {
+            ++stats_.hits;
+            return it->second;
+        }
+        ++stats_.misses;
+
+        if (!decrypt_) {
+            // Без закрытого ключа остаётся только полная таблица открытого ключа
+            warmUp();
+            it = reverse_.find(cipher);
+            if (it == reverse_.end()) {
+                throw std::runtime_error("Шифртекст отсутствует в кодовой книге");
+            }
+            return it->second;
+        }
+        const uint64_t plain = decrypt_(cipher);
+        if (plain > 0xFF) {
+            throw std::runtime_error("Шифртекст не соответствует однобайтовому блоку");
+        }
+        reverse_.emplace(cipher, static_cast<uint8_t>(plain));
+        return static_cast<uint8_t>(plain);
+    }
+
+    // Заполняет таблицу для всех 256 байт операциями открытым ключом.
+    // Для потоковой обработки больших объёмов это дешевле, чем до 256
+    // операций закрытым ключом (показатель e обычно гораздо короче d).
+    void warmUp() {
+        if (!encrypt_) return;
+        for (unsigned b = 0; b < 256; ++b) {
+            if (!known_[b]) remember(static_cast<uint8_t>(b), encrypt_(b));
+        }
+    }
+
+    // Полная таблица открытого ключа (256 значений) для сохранения вместе с
+    // ключом; недостающие значения вычисляются
+    void exportTable(uint64_t* out) {
+        warmUp();
+        for (unsigned b = 0; b < 256; ++b) {
+            if (!known_[b]) {
+                throw std::logic_error("Кодовая книга без открытого ключа не заполнена");
+            }
+            out[b] = table_[b];
+        }
+    }
+
+    // Загрузка сохранённой таблицы: все 256 значений известны, расшифрование
+    // корректного шифртекста идёт только по обратной таблице
+    void importTable(const uint64_t* table) {
+        for (unsigned b = 0; b < 256; ++b) {
+            if (known_[b] && table_[b] != table[b]) {
+                throw std::invalid_argument("Таблица не соответствует ключу кодовой книги");
+            }
+            remember(static_cast<uint8_t>(b), table[b]);
+        }
+        for (unsigned b = 0; b < 256; ++b) {
+            if (reverse_.at(table[b]) != b) {
+                throw std::invalid_argument("Таблица кодовой книги содержит повторы");
+            }
+        }
+    }
+
+    Stats stats() const noexcept { return stats_; }
+    void resetStats() noexcept { stats_ = Stats(); }
+
+private:
+    Transform encrypt_;
+    Transform decrypt_;
+    std::array<uint64_t, 256> table_{};
+    std::array<bool, 256> known_;
+    std::unordered_map<uint64_t, uint8_t> reverse_;
+    Stats stats_;
+
+    uint64_t remember(uint8_t byte, uint64_t cipher) {
+        table_[byte] = cipher;
+        known_[byte] = true;
+        reverse_.emplace(cipher, byte);
+        return cipher;
+    }
+};
+
+#endif // BYTE_CODEBOOK_H
@@ -0,0 +1,175 @@
+#ifndef CHUNK_PIPELINE_H
+#define CHUNK_PIPELINE_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Конвейер обработки потока кусками: поток чтения, пул обработчиков и запись
+// в исходном порядке.
+//
+// Поток чтения заполняет входные буферы и нумерует куски, обработчики берут
+// куски из очереди в любом порядке, а вызывающий поток записывает результаты
+// строго по возрастанию номера, так что вывод не зависит от числа потоков.
+// Буферы переиспользуются: в обработке одновременно не больше 2 * threads + 2
+// кусков, поэтому память ограничена независимо от размера файла.
+//
+// Исключение из любого этапа останавливает конвейер и пробрасывается из
+// runChunkPipeline после завершения всех потоков.
+
+struct PipelineBuffer {
+    std::vector<uint8_t> data;
+    size_t size = 0;
+};
+
+// Число потоков по умолчанию (0 - все ядра)
+inline unsigned pipelineThreads(unsigned threads) {
+    if (threads != 0) return threads;
+    const unsigned hw = std::thread::hardware_concurrency();
+    return hw != 0 ? hw : 1;
+}
+
+// Чтение, обработка и запись в отдельных потоках, workers обработчиков.
+// При workers == 1 куски обрабатываются строго по порядку, а чтение и запись
+// перекрываются с обработкой (для преобразований с состоянием между кусками).
+// Параметры - как у runChunkPipeline.
+template <typename Read, typename MakeWorker, typename Write>
+void runChunkPipelineThreaded(unsigned workerCount, Read read, MakeWorker makeWorker, Write write) {
+    const unsigned threads = workerCount != 0 ? workerCount : 1;
+
+    struct Chunk {
+        uint64_t index = 0;
+        PipelineBuffer in;
+        PipelineBuffer out;
+    };
+
+    std::vector<Chunk> storage(2 * threads + 2);
+    std::vector<Chunk*> idle;
+    for (auto& chunk : storage) idle.push_back(&chunk);
+    std::deque<Chunk*> pending;
+    std::map<uint64_t, Chunk*> done;
+
+    std::mutex mutex;
+    std::condition_variable changed;
+    uint64_t chunksRead = 0;
+    bool readFinished = false;
+    bool failed = false;
+    std::exception_ptr error;
+
+    auto fail = [&](std::exception_ptr e) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!failed) {
+            failed = true;
+            error = e;
+        }
+        changed.notify_all();
+    };
+
+    std::thread reader([&] {
+        try {
+            for (;;) {
+                Chunk* chunk;
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    changed.wait(lock, [&] { return failed || !idle.empty(); });
+                    if (failed) return;
+                    chunk = idle.back();
+                    idle.pop_back();
+                }
+                const bool more = read(chunk->in);
+                std::lock_guard<std::mutex> lock(mutex);
+                if (!more) {
+                    idle.push_back(chunk);
+                    readFinished = true;
+                    changed.notify_all();
+                    return;
+                }
+                chunk->index = chunksRead++;
+                pending.push_back(chunk);
+                changed.notify_all();
+            }
+        } catch (...) {
+            fail(std::current_exception());
+        }
+    });
+
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < threads; ++t) {
+        workers.emplace_back([&] {
+            try {
+                auto worker = makeWorker();
+                for (;;) {
+                    Chunk* chunk;
+                    {
+                        std::unique_lock<std::mutex> lock(mutex);
+                        changed.wait(lock, [&] { return failed || !pending.empty() || readFinished; });
+                        if (failed || pending.empty()) return;
+                        chunk = pending.front();
+                        pending.pop_front();
+                    }
+                    worker(chunk->index, chunk->in, chunk->out);
+                    std::lock_guard<std::mutex> lock(mutex);
+                    done.emplace(chunk->index, chunk);
+                    changed.notify_all();
+                }
+            } catch (...) {
+                fail(std::current_exception());
+            }
+        });
+    }
+
+    // Запись в вызывающем потоке по порядку номеров
+    try {
+        for (uint64_t next = 0;; ++next) {
+            Chunk* chunk;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                changed.wait(lock, [&] {
+                    return failed || done.count(next) != 0 || (readFinished && next == chunksRead);
+                });
+                if (failed || done.count(next) == 0) break;
+                chunk = done[next];
+                done.erase(next);
+            }
+            write(chunk->out);
+            std::lock_guard<std::mutex> lock(mutex);
+            idle.push_back(chunk);
+            changed.notify_all();
+        }
+    } catch (...) {
+        fail(std::current_exception());
+    }
+
+    reader.join();
+    for (auto& worker : workers) worker.join();
+    if (error) std::rethrow_exception(error);
+}
+
+// read(PipelineBuffer& in) -> bool          - false, когда данные закончились
+// makeWorker() -> worker                    - вызывается один раз в каждом потоке обработки
+// worker(uint64_t index, const PipelineBuffer& in, PipelineBuffer& out)
+// write(const PipelineBuffer& out)
+template <typename Read, typename MakeWorker, typename Write>
+void runChunkPipeline(unsigned threads, Read read, MakeWorker makeWorker, Write write) {
+    threads = pipelineThreads(threads);
+
+    // Один поток: без очередей и синхронизации
+    if (threads == 1) {
+        auto worker = makeWorker();
+        PipelineBuffer in, out;
+        for (uint64_t index = 0; read(in); ++index) {
+            worker(index, in, out);
+            write(out);
+        }
+        return;
+    }
+    runChunkPipelineThreaded(threads, read, makeWorker, write);
+}
+
+#endif // CHUNK_PIPELINE_H
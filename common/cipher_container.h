@@ -0,0 +1,280 @@
+#ifndef CIPHER_CONTAINER_H
+#define CIPHER_CONTAINER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include "stream_cipher.h"
+
+// Двоичный контейнер шифртекста RSA/LUC с небольшим модулем.
+//
+// Заголовок (16 байт, little-endian):
+//   0  "RLC1"     - сигнатура и версия формата
+//   4  algorithm  - алгоритм (ContainerAlgorithm)
+//   5  blockBytes - байт открытого текста в блоке (1..7)
+//   6  wordBytes  - байт на слово шифртекста (1..8, хватает для n - 1)
+//   7  0          - зарезервировано
+//   8  plainSize  - длина открытого текста, uint64
+// Далее ceil(plainSize / blockBytes) слов шифртекста по wordBytes байт (little-endian).
+// Последний блок дополняется нулями; длина из заголовка отрезает дополнение.
+//
+// Данные обрабатываются кусками по CONTAINER_CHUNK_BLOCKS блоков; куски
+// независимы, поэтому шифруются параллельно общим драйвером stream_cipher.h.
+
+enum class ContainerAlgorithm : uint8_t {
+    RSA = 1,
+    LUC = 2
+};
+
+struct ContainerHeader {
+    ContainerAlgorithm algorithm;
+    uint8_t blockBytes;
+    uint8_t wordBytes;
+    uint64_t plainSize;
+};
+
+constexpr size_t CONTAINER_HEADER_SIZE = 16;
+constexpr size_t CONTAINER_CHUNK_BLOCKS = size_t{1} << 16;
+
+// Число байт, достаточное для любого остатка по модулю n
+inline uint8_t wordBytesForModulus(uint64_t n) {
+    uint64_t max = n - 1;
+    uint8_t bytes = 1;
+    while (bytes < 8 && (max >> (8 * bytes)) != 0) ++bytes;
+    return bytes;
+}
+
+inline void storeWordLE(uint64_t value, size_t wordBytes, uint8_t* out) {
+    for (size_t i = 0; i < wordBytes; ++i) {
+        out[i] = static_cast<uint8_t>(value >> (8 * i));
+    }
+}
+
+inline uint64_t loadWordLE(const uint8_t* data, size_t wordBytes) {
+    uint64_t value = 0;
+    for (size_t i = wordBytes; i-- > 0;) {
+        value = (value << 8) | data[i];
+    }
+    return value;
+}
+
+inline ContainerHeader makeContainerHeader(ContainerAlgorithm algorithm, uint64_t n,
+                                           size_t blockBytes, uint64_t plainSize) {
+    if (blockBytes == 0 || blockBytes > 7 || (n >> (8 * blockBytes)) == 0) {
+        throw std::invalid_argument("Модуль слишком мал для выбранного размера блока");
+    }
+    return ContainerHeader{algorithm, static_cast<uint8_t>(blockBytes), wordBytesForModulus(n), plainSize};
+}
+
+inline uint64_t containerBlockCount(const ContainerHeader& header) {
+    return (header.plainSize + header.blockBytes - 1) / header.blockBytes;
+}
+
+inline void writeContainerHeader(std::ostream& out, const ContainerHeader& header) {
+    uint8_t raw[CONTAINER_HEADER_SIZE] = {'R', 'L', 'C', '1'};
+    raw[4] = static_cast<uint8_t>(header.algorithm);
+    raw[5] = header.blockBytes;
+    raw[6] = header.wordBytes;
+    raw[7] = 0;
+    storeWordLE(header.plainSize, 8, raw + 8);
+    out.write(reinterpret_cast<const char*>(raw), CONTAINER_HEADER_SIZE);
+}
+
+inline ContainerHeader readContainerHeader(std::istream& in, ContainerAlgorithm expected) {
+    uint8_t raw[CONTAINER_HEADER_SIZE];
+    if (!in.read(reinterpret_cast<char*>(raw), CONTAINER_HEADER_SIZE) ||
+        raw[0] != 'R' || raw[1] != 'L' || raw[2] != 'C' || raw[3] != '1') {
+        throw std::runtime_error("Файл не является контейнером шифртекста");
+    }
+    if (raw[4] != static_cast<uint8_t>(expected)) {
+        throw std::runtime_error("Контейнер создан другим алгоритмом");
+    }
+    ContainerHeader header{expected, raw[5], raw[6], loadWordLE(raw + 8, 8)};
+    if (header.blockBytes == 0 || header.blockBytes > 7 || header.wordBytes == 0 ||
+        header.wordBytes > 8 || header.wordBytes < header.blockBytes) {
+        throw std::runtime_error("Некорректный заголовок контейнера");
+    }
+    return header;
+}
+
+// Кусок открытого текста -> слова шифртекста. size байт дают
+// ceil(size / blockBytes) слов; неполный последний блок дополняется нулями.
+template <typename Transform>
+void encryptContainerChunk(const uint8_t* plain, size_t size, const ContainerHeader& header,
+                           uint8_t* words, Transform&& transform) {
+    const size_t k = header.blockBytes, w = header.wordBytes;
+    size_t i = 0;
+    for (; i + k <= size; i += k, words += w) {
+        uint64_t block = 0;
+        for (size_t j = 0; j < k; ++j) block = (block << 8) | plain[i + j];
+        storeWordLE(transform(block), w, words);
+    }
+    if (i < size) {
+        uint64_t block = 0;
+        for (size_t j = 0; j < k; ++j) block = (block << 8) | (i + j < size ? plain[i + j] : 0);
+        storeWordLE(transform(block), w, words);
+    }
+}
+
+// Слова шифртекста -> открытый текст; plainSize - сколько байт нужно вывести
+template <typename Transform>
+void decryptContainerChunk(const uint8_t* words, size_t plainSize, const ContainerHeader& header,
+                           uint8_t* plain, Transform&& transform) {
+    const size_t k = header.blockBytes, w = header.wordBytes;
+    for (size_t i = 0; i < plainSize; i += k, words += w) {
+        const uint64_t block = transform(loadWordLE(words, w));
+        if ((block >> (8 * k)) != 0) {
+            throw std::runtime_error("Блок шифртекста расшифрован некорректно (неверный ключ?)");
+        }
+        for (size_t j = 0; j < k; ++j) {
+            if (i + j < plainSize) plain[i + j] = static_cast<uint8_t>(block >> (8 * (k - 1 - j)));
+        }
+    }
+}
+
+// Преобразование открытого текста в слова контейнера; transform - одно
+// преобразование блока (uint64_t -> uint64_t), makeTransform() даёт копию
+// для каждого потока обработки
+template <typename MakeTransform>
+class ContainerEncryptTransform : public BlockTransform {
+public:
+    ContainerEncryptTransform(const ContainerHeader& header, MakeTransform makeTransform)
+        : header_(header), makeTransform_(makeTransform), transform_(makeTransform_()) {}
+
+    size_t chunkSize() const override { return CONTAINER_CHUNK_BLOCKS * header_.blockBytes; }
+    size_t maxOutputSize(size_t size) const override {
+        return (size + header_.blockBytes - 1) / header_.blockBytes * header_.wordBytes;
+    }
+
+    size_t process(uint64_t, const uint8_t* in, size_t size, uint8_t* out) override {
+        encryptContainerChunk(in, size, header_, out, transform_);
+        return maxOutputSize(size);
+    }
+
+    std::unique_ptr<BlockTransform> clone() const override {
+        return std::unique_ptr<BlockTransform>(new ContainerEncryptTransform(header_, makeTransform_));
+    }
+
+    void finish(uint64_t inputSize) override {
+        if (inputSize != header_.plainSize) {
+            throw std::runtime_error("Размер входного файла изменился во время шифрования");
+        }
+    }
+
+private:
+    ContainerHeader header_;
+    MakeTransform makeTransform_;
+    decltype(std::declval<MakeTransform&>()()) transform_;
+};
+
+// Слова контейнера (после заголовка) -> открытый текст длиной plainSize
+template <typename MakeTransform>
+class ContainerDecryptTransform : public BlockTransform {
+public:
+    ContainerDecryptTransform(const ContainerHeader& header, MakeTransform makeTransform)
+        : header_(header), makeTransform_(makeTransform), transform_(makeTransform_()) {}
+
+    size_t chunkSize() const override { return CONTAINER_CHUNK_BLOCKS * header_.wordBytes; }
+    size_t maxOutputSize(size_t size) const override { return size / header_.wordBytes * header_.blockBytes; }
+
+    size_t process(uint64_t offset, const uint8_t* in, size_t size, uint8_t* out) override {
+        const uint64_t plainStart = offset / header_.wordBytes * header_.blockBytes;
+        if (plainStart >= header_.plainSize) return 0;  // лишние данные после контейнера
+        const uint64_t rest = header_.plainSize - plainStart;
+        const size_t plainSize = static_cast<size_t>(rest < maxOutputSize(size) ? rest : maxOutputSize(size));
+        if (plainSize < rest && size < chunkSize()) {
+            throw std::runtime_error("Контейнер обрезан");
+        }
+        decryptContainerChunk(in, plainSize, header_, out, transform_);
+        return plainSize;
+    }
+
+    std::unique_ptr<BlockTransform> clone() const override {
+        return std::unique_ptr<BlockTransform>(new ContainerDecryptTransform(header_, makeTransform_));
+    }
+
+    void finish(uint64_t inputSize) override {
+        if (inputSize < containerBlockCount(header_) * header_.wordBytes) {
+            throw std::runtime_error("Контейнер обрезан");
+        }
+    }
+
+private:
+    ContainerHeader header_;
+    MakeTransform makeTransform_;
+    decltype(std::declval<MakeTransform&>()()) transform_;
+};
+
+// Шифрует остаток потока in в контейнер out (драйвер runBlockTransform).
+// makeTransform() вызывается один раз в каждом потоке обработки: преобразование
+// с состоянием (например, кодовая книга) должно возвращать независимую копию.
+// threads == 0 - все ядра; порядок и содержимое вывода от threads не зависят.
+template <typename MakeTransform>
+void encryptContainer(std::istream& in, std::ostream& out, const ContainerHeader& header,
+                      MakeTransform makeTransform, unsigned threads = 1) {
+    writeContainerHeader(out, header);
+    ContainerEncryptTransform<MakeTransform> transform(header, makeTransform);
+    runBlockTransform(in, out, transform, threads);
+}
+
+// Расшифровывает контейнер (заголовок уже прочитан readContainerHeader)
+template <typename MakeTransform>
+void decryptContainer(std::istream& in, std::ostream& out, const ContainerHeader& header,
+                      MakeTransform makeTransform, unsigned threads = 1) {
+    ContainerDecryptTransform<MakeTransform> transform(header, makeTransform);
+    runBlockTransform(in, out, transform, threads);
+}
+
+// Шифр с контейнером RSA/LUC для общего драйвера: модуль n, blockBytes байт
+// открытого текста в блоке; makeEncrypt/makeDecrypt - как makeTransform выше
+template <typename MakeEncrypt, typename MakeDecrypt>
+class ContainerStreamCipher : public StreamCipher {
+public:
+    ContainerStreamCipher(const char* name, ContainerAlgorithm algorithm, uint64_t n, size_t blockBytes,
+                          MakeEncrypt makeEncrypt, MakeDecrypt makeDecrypt)
+        : name_(name), algorithm_(algorithm), n_(n), blockBytes_(blockBytes),
+          makeEncrypt_(makeEncrypt), makeDecrypt_(makeDecrypt) {}
+
+    const char* name() const override { return name_; }
+
+    std::unique_ptr<BlockTransform> encryptor(std::ostream& out, uint64_t plainSize) override {
+        // Длина открытого текста пишется в заголовок до данных
+        if (plainSize == UNKNOWN_STREAM_SIZE) {
+            throw std::runtime_error("Шифрование контейнера требует входной файл с известным размером");
+        }
+        const ContainerHeader header = makeContainerHeader(algorithm_, n_, blockBytes_, plainSize);
+        writeContainerHeader(out, header);
+        return std::unique_ptr<BlockTransform>(new ContainerEncryptTransform<MakeEncrypt>(header, makeEncrypt_));
+    }
+
+    std::unique_ptr<BlockTransform> decryptor(std::istream& in) override {
+        const ContainerHeader header = readContainerHeader(in, algorithm_);
+        if (header.blockBytes != blockBytes_ || header.wordBytes != wordBytesForModulus(n_)) {
+            throw std::runtime_error("Контейнер создан с другим размером блока или модулем");
+        }
+        return std::unique_ptr<BlockTransform>(new ContainerDecryptTransform<MakeDecrypt>(header, makeDecrypt_));
+    }
+
+private:
+    const char* name_;
+    ContainerAlgorithm algorithm_;
+    uint64_t n_;
+    size_t blockBytes_;
+    MakeEncrypt makeEncrypt_;
+    MakeDecrypt makeDecrypt_;
+};
+
+template <typename MakeEncrypt, typename MakeDecrypt>
+std::unique_ptr<StreamCipher> makeContainerStreamCipher(const char* name, ContainerAlgorithm algorithm, uint64_t n,
+                                                        size_t blockBytes, MakeEncrypt makeEncrypt,
+                                                        MakeDecrypt makeDecrypt) {
+    return std::unique_ptr<StreamCipher>(new ContainerStreamCipher<MakeEncrypt, MakeDecrypt>(
+        name, algorithm, n, blockBytes, makeEncrypt, makeDecrypt));
+}
+
+#endif // CIPHER_CONTAINER_H
@@ -0,0 +1,118 @@
+#ifndef HEX_CODEC_H
+#define HEX_CODEC_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define HEX_CODEC_SSE2 1
+#endif
+
+// Шестнадцатеричное кодирование без потоков ввода-вывода.
+//
+// Кодирование пишет в заранее выделенный буфер: байт -> два символа из
+// таблицы на 256 пар, а на x86-64 по 16 байт за шаг через SSE2 (входит в
+// базовый набор инструкций, проверка процессора не нужна). Вывод в нижнем
+// регистре, как у std::hex. Декодирование принимает оба регистра и
+// проверяет каждый символ по таблице.
+
+namespace hex_detail {
+
+constexpr char DIGITS[] = "0123456789abcdef";
+
+constexpr std::array<char, 512> makeEncodeTable() {
+    std::array<char, 512> table{};
+    for (size_t i = 0; i < 256; ++i) {
+        table[2 * i] = DIGITS[i >> 4];
+        table[2 * i + 1] = DIGITS[i & 0xf];
+    }
+    return table;
+}
+
+// Значение символа или -1 для недопустимого
+constexpr std::array<int8_t, 256> makeDecodeTable() {
+    std::array<int8_t, 256> table{};
+    for (size_t i = 0; i < 256; ++i) table[i] = -1;
+    for (int i = 0; i < 10; ++i) table['0' + i] = static_cast<int8_t>(i);
+    for (int i = 0; i < 6; ++i) {
+        table['a' + i] = static_cast<int8_t>(10 + i);
+        table['A' + i] = static_cast<int8_t>(10 + i);
+    }
+    return table;
+}
+
+inline constexpr std::array<char, 512> ENCODE = makeEncodeTable();
+inline constexpr std::array<int8_t, 256> DECODE = makeDecodeTable();
+
+#ifdef HEX_CODEC_SSE2
+// Полубайты 0..15 -> '0'..'9', 'a'..'f': '0' + n, и ещё 39 для n > 9
+inline __m128i nibblesToChars(__m128i n) {
+    const __m128i above9 = _mm_cmpgt_epi8(n, _mm_set1_epi8(9));
+    return _mm_add_epi8(_mm_add_epi8(n, _mm_set1_epi8('0')), _mm_and_si128(above9, _mm_set1_epi8(39)));
+}
+#endif
+
+} // namespace hex_detail
+
+inline size_t hexEncodedSize(size_t size) {
+    return 2 * size;
+}
+
+// size байт -> 2 * size символов в out (без завершающего нуля)
+inline void hexEncode(const uint8_t* data, size_t size, char* out) {
+    size_t i = 0;
+#ifdef HEX_CODEC_SSE2
+    const __m128i low4 = _mm_set1_epi8(0x0f);
+    for (; i + 16 <= size; i += 16, out += 32) {
+        const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        const __m128i high = hex_detail::nibblesToChars(_mm_and_si128(_mm_srli_epi16(bytes, 4), low4));
+        const __m128i low = hex_detail::nibblesToChars(_mm_and_si128(bytes, low4));
+        // Старший полубайт каждого байта идёт первым
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_unpacklo_epi8(high, low));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 16), _mm_unpackhi_epi8(high, low));
+    }
+#endif
+    for (; i < size; ++i, out += 2) {
+        out[0] = hex_detail::ENCODE[2 * data[i]];
+        out[1] = hex_detail::ENCODE[2 * data[i] + 1];
+    }
+}
+
+inline std::string hexEncode(const uint8_t* data, size_t size) {
+    std::string out(hexEncodedSize(size), '\0');
+    hexEncode(data, size, &out[0]);
+    return out;
+}
+
+inline std::string hexEncode(const std::vector<uint8_t>& data) {
+    return hexEncode(data.data(), data.size());
+}
+
+// length символов -> length / 2 байт в out; возвращает число байт
+inline size_t hexDecode(const char* hex, size_t length, uint8_t* out) {
+    if (length % 2 != 0) {
+        throw std::invalid_argument("Длина шестнадцатеричной строки должна быть чётной");
+    }
+    for (size_t i = 0; i < length; i += 2) {
+        const int high = hex_detail::DECODE[static_cast<uint8_t>(hex[i])];
+        const int low = hex_detail::DECODE[static_cast<uint8_t>(hex[i + 1])];
+        if ((high | low) < 0) {
+            throw std::invalid_argument("Недопустимый символ в шестнадцатеричной строке");
+        }
+        out[i / 2] = static_cast<uint8_t>((high << 4) | low);
+    }
+    return length / 2;
+}
+
+inline std::vector<uint8_t> hexDecode(const std::string& hex) {
+    std::vector<uint8_t> out(hex.size() / 2);
+    hexDecode(hex.data(), hex.size(), out.data());
+    return out;
+}
+
+#endif // HEX_CODEC_H
@@ -0,0 +1,169 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Файл, отображённый в память (mmap / MapViewOfFile), для обработки без
+// копирования в буферы.
+//
+// openRead - существующий файл только для чтения: страницы подгружаются при
+// первом обращении, повторный запуск берёт их из файлового кеша ОС.
+// create - новый (или перезаписанный) файл заданного размера для записи.
+// Данные действительны, пока жив объект; объект только перемещается.
+// Пустой файл не отображается: data() == nullptr, size() == 0.
+class MappedFile {
+public:
+    static MappedFile openRead(const std::string& path) {
+#ifdef _WIN32
+        HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                  FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) {
+            throw std::runtime_error("Не удалось открыть файл: " + path);
+        }
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(file, &size)) {
+            CloseHandle(file);
+            throw std::runtime_error("Не удалось определить размер файла: " + path);
+        }
+        return mapWindows(file, static_cast<size_t>(size.QuadPart), false, path);
+#else
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw std::runtime_error("Не удалось открыть файл: " + path);
+        }
+        struct stat st;
+        if (::fstat(fd, &st) != 0) {
+            ::close(fd);
+            throw std::runtime_error("Не удалось определить размер файла: " + path);
+        }
+        return mapPosix(fd, static_cast<size_t>(st.st_size), PROT_READ, path);
+#endif
+    }
+
+    static MappedFile create(const std::string& path, size_t size) {
+#ifdef _WIN32
+        HANDLE file = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS,
+                                  FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) {
+            throw std::runtime_error("Не удалось создать файл: " + path);
+        }
+        LARGE_INTEGER end;
+        end.QuadPart = static_cast<LONGLONG>(size);
+        if (!SetFilePointerEx(file, end, nullptr, FILE_BEGIN) || !SetEndOfFile(file)) {
+            CloseHandle(file);
+            throw std::runtime_error("Не удалось задать размер файла: " + path);
+        }
+        return mapWindows(file, size, true, path);
+#else
+        const int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) {
+            throw std::runtime_error("Не удалось создать файл: " + path);
+        }
+        if (::ftruncate(fd, static_cast<off_t>(size)) != 0) {
+            ::close(fd);
+            throw std::runtime_error("Не удалось задать размер файла: " + path);
+        }
+        return mapPosix(fd, size, PROT_READ | PROT_WRITE, path);
+#endif
+    }
+
+    MappedFile(MappedFile&& other) noexcept : data_(other.data_), size_(other.size_) {
+        other.data_ = nullptr;
+        other.size_ = 0;
+    }
+
+    MappedFile& operator=(MappedFile&& other) noexcept {
+        if (this != &other) {
+            unmap();
+            data_ = other.data_;
+            size_ = other.size_;
+            other.data_ = nullptr;
+            other.size_ = 0;
+        }
+        return *this;
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    ~MappedFile() { unmap(); }
+
+    // Начало отображения выровнено по странице. Запись через data() допустима
+    // только для файла из create
+    uint8_t* data() noexcept { return data_; }
+    const uint8_t* data() const noexcept { return data_; }
+    size_t size() const noexcept { return size_; }
+
+    // Подсказка ядру: файл читается/пишется последовательно (упреждающее чтение)
+    void adviseSequential() const noexcept {
+#ifndef _WIN32
+        if (data_ != nullptr) ::madvise(data_, size_, MADV_SEQUENTIAL);
+#endif
+    }
+
+private:
+    uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+
+    MappedFile(uint8_t* data, size_t size) noexcept : data_(data), size_(size) {}
+
+#ifdef _WIN32
+    // Забирает и закрывает file; отображение держит файл открытым само
+    static MappedFile mapWindows(HANDLE file, size_t size, bool writable, const std::string& path) {
+        void* view = nullptr;
+        if (size > 0) {
+            HANDLE mapping = CreateFileMappingA(file, nullptr, writable ? PAGE_READWRITE : PAGE_READONLY, 0, 0,
+                                                nullptr);
+            if (mapping != nullptr) {
+                view = MapViewOfFile(mapping, writable ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, 0);
+                CloseHandle(mapping);
+            }
+        }
+        CloseHandle(file);
+        if (size > 0 && view == nullptr) {
+            throw std::runtime_error("Не удалось отобразить файл в память: " + path);
+        }
+        return MappedFile(static_cast<uint8_t*>(view), size);
+    }
+#else
+    // Забирает и закрывает fd; отображение держит файл открытым само
+    static MappedFile mapPosix(int fd, size_t size, int protection, const std::string& path) {
+        void* data = nullptr;
+        if (size > 0) {
+            data = ::mmap(nullptr, size, protection, MAP_SHARED, fd, 0);
+        }
+        ::close(fd);
+        if (data == MAP_FAILED) {
+            throw std::runtime_error("Не удалось отобразить файл в память: " + path);
+        }
+        return MappedFile(static_cast<uint8_t*>(data), size);
+    }
+#endif
+
+    void unmap() noexcept {
+        if (data_ == nullptr) return;
+#ifdef _WIN32
+        UnmapViewOfFile(data_);
+#else
+        ::munmap(data_, size_);
+#endif
+        data_ = nullptr;
+    }
+};
+
+#endif // MAPPED_FILE_H
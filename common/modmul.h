@@ -0,0 +1,291 @@
+#ifndef MODMUL_H
+#define MODMUL_H
+
+#include <cstdint>
+#include <stdexcept>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+// Умножение по 64-битному модулю с выбираемой реализацией.
+//
+//  - BitSerial: удвоение и сложение по битам множителя (прежний mulmod
+//    учебных программ RSA), O(log b) делений на одно умножение;
+//  - Int128: одно 128-битное произведение и одно деление;
+//  - Montgomery: REDC без деления (Montgomery64); константы модуля
+//    (n^-1 mod 2^64, R^2 mod n) вычисляются один раз в ModArith и
+//    переиспользуются для всех блоков одного ключа.
+
+enum class MulModBackend {
+    BitSerial,
+    Int128,
+    Montgomery,
+};
+
+inline const char* mulModBackendName(MulModBackend backend) {
+    switch (backend) {
+        case MulModBackend::BitSerial: return "bit-serial";
+        case MulModBackend::Int128: return "int128";
+        case MulModBackend::Montgomery: return "montgomery";
+    }
+    return "?";
+}
+
+namespace modmul_detail {
+
+#if !defined(_MSC_VER) || defined(__clang__)
+// __extension__: без предупреждения -Wpedantic в проектах со строгими флагами
+__extension__ typedef unsigned __int128 uint128;
+#endif
+
+// Полное 128-битное произведение a * b = (hi, lo)
+inline void mul128(uint64_t a, uint64_t b, uint64_t& hi, uint64_t& lo) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    lo = _umul128(a, b, &hi);
+#else
+    const uint128 p = static_cast<uint128>(a) * b;
+    hi = static_cast<uint64_t>(p >> 64);
+    lo = static_cast<uint64_t>(p);
+#endif
+}
+
+} // namespace modmul_detail
+
+// (a * b) % mod сложениями и удвоениями; mod < 2^63
+inline uint64_t mulModBitSerial(uint64_t a, uint64_t b, uint64_t mod) {
+    uint64_t res = 0;
+    a %= mod;
+    while (b > 0) {
+        if (b & 1) res = (res + a) % mod;
+        a = (a * 2) % mod;
+        b >>= 1;
+    }
+    return res;
+}
+
+// (a * b) % mod через 128-битное произведение
+inline uint64_t mulMod64(uint64_t a, uint64_t b, uint64_t mod) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    uint64_t hi, lo, rem;
+    modmul_detail::mul128(a % mod, b % mod, hi, lo);
+    _udiv128(hi, lo, mod, &rem);
+    return rem;
+#else
+    return static_cast<uint64_t>(static_cast<modmul_detail::uint128>(a) * b % mod);
+#endif
+}
+
+namespace modmul_detail {
+
+inline int bitLength(uint64_t x) {
+    int bits = 0;
+    while (x) {
+        ++bits;
+        x >>= 1;
+    }
+    return bits;
+}
+
+// Ширина окна в зависимости от длины показателя степени
+inline int windowSize(int bits) {
+    if (bits <= 8) return 1;
+    if (bits <= 24) return 3;
+    return 4;
+}
+
+constexpr int MAX_WINDOW = 4;
+
+// Бинарное возведение в степень (справа налево) с заданным умножением
+template <typename Mul>
+uint64_t powWith(uint64_t base, uint64_t exp, uint64_t one, Mul mul) {
+    uint64_t result = one;
+    for (; exp > 0; exp >>= 1) {
+        if (exp & 1) result = mul(result, base);
+        base = mul(base, base);
+    }
+    return result;
+}
+
+// Возведение в степень скользящим окном (слева направо).
+// mul - умножение в выбранном представлении, one - единица в нём же.
+template <typename Mul>
+uint64_t slidingWindowPow(uint64_t base, uint64_t exp, uint64_t one, Mul mul) {
+    if (exp == 0) return one;
+
+    const int bits = bitLength(exp);
+    const int w = windowSize(bits);
+
+    // Нечётные степени: base^1, base^3, ..., base^(2^w - 1)
+    uint64_t table[1 << (MAX_WINDOW - 1)];
+    table[0] = base;
+    if (w > 1) {
+        uint64_t sq = mul(base, base);
+        for (int i = 1; i < (1 << (w - 1)); ++i) {
+            table[i] = mul(table[i - 1], sq);
+        }
+    }
+
+    uint64_t result = one;
+    bool started = false;
+    int i = bits - 1;
+    while (i >= 0) {
+        if (((exp >> i) & 1) == 0) {
+            if (started) result = mul(result, result);
+            --i;
+            continue;
+        }
+
+        // Самое длинное окно не шире w, заканчивающееся единичным битом
+        int low = i - w + 1 < 0 ? 0 : i - w + 1;
+        while (((exp >> low) & 1) == 0) ++low;
+        const int len = i - low + 1;
+        const uint64_t value = (exp >> low) & ((uint64_t{1} << len) - 1);
+
+        if (started) {
+            for (int k = 0; k < len; ++k) result = mul(result, result);
+            result = mul(result, table[value >> 1]);
+        } else {
+            result = table[value >> 1];
+            started = true;
+        }
+        i = low - 1;
+    }
+    return result;
+}
+
+} // namespace modmul_detail
+
+// Контекст умножения Монтгомери для фиксированного нечётного модуля n > 2,
+// R = 2^64. Константы (n^-1 mod 2^64 и R^2 mod n) вычисляются один раз в
+// конструкторе, после чего умножение обходится без деления. Единственная
+// реализация REDC в репозитории: ей пользуются ModArith, isPrime64 и
+// modexp.h в CryptoApp.
+class Montgomery64 {
+public:
+    // Константы модуля: сохраняются вместе с ключом (файл ключа), чтобы
+    // восстанавливать контекст без вычисления обратного и R^2 mod n
+    struct Constants {
+        uint64_t n = 0;
+        uint64_t nInv = 0;  // n^-1 mod 2^64
+        uint64_t r2 = 0;    // R^2 mod n
+        uint64_t one = 0;   // R mod n
+    };
+
+    // Пустой контекст (для массивов и отложенной инициализации); до
+    // присваивания настоящего контекста использовать нельзя
+    Montgomery64() = default;
+
+    explicit Montgomery64(uint64_t mod) : n_(mod) {
+        if (mod < 3 || (mod & 1) == 0) {
+            throw std::invalid_argument("Модуль Монтгомери должен быть нечётным и больше 1");
+        }
+        // Метод Ньютона: каждая итерация удваивает число верных бит обратного
+        uint64_t inv = mod;
+        for (int i = 0; i < 5; ++i) inv *= 2 - mod * inv;
+        nInv_ = inv;
+        one_ = (0 - mod) % mod;          // 2^64 mod n
+        r2_ = mulMod64(one_, one_, mod);  // 2^128 mod n
+    }
+
+    // Из готовых констант; несогласованные константы - invalid_argument
+    explicit Montgomery64(const Constants& constants)
+        : n_(constants.n), nInv_(constants.nInv), r2_(constants.r2), one_(constants.one) {
+        if (n_ < 3 || (n_ & 1) == 0 || n_ * nInv_ != 1 || one_ >= n_ || r2_ >= n_ || mul(r2_, 1) != one_) {
+            throw std::invalid_argument("Несогласованные константы Монтгомери");
+        }
+    }
+
+    Constants constants() const noexcept { return {n_, nInv_, r2_, one_}; }
+
+    uint64_t modulus() const noexcept { return n_; }
+    // Единица (R mod n) в форме Монтгомери
+    uint64_t one() const noexcept { return one_; }
+
+    // Перевод в форму Монтгомери и обратно
+    uint64_t toMont(uint64_t a) const { return mul(a % n_, r2_); }
+    uint64_t fromMont(uint64_t a) const { return mul(a, 1); }
+
+    // a * b * R^-1 mod n (REDC) для a, b < n в форме Монтгомери
+    uint64_t mul(uint64_t a, uint64_t b) const {
+        // (a*b - m*n) / 2^64, где m = lo * n^-1 mod 2^64 обнуляет младшее слово
+        uint64_t hi, lo, mh, ml;
+        modmul_detail::mul128(a, b, hi, lo);
+        modmul_detail::mul128(lo * nInv_, n_, mh, ml);
+        const uint64_t res = hi - mh;
+        return hi < mh ? res + n_ : res;
+    }
+
+    // base^exp mod n скользящим окном (аргумент и результат в обычной форме)
+    uint64_t pow(uint64_t base, uint64_t exp) const {
+        return fromMont(modmul_detail::slidingWindowPow(toMont(base), exp, one_,
+                                                        [this](uint64_t a, uint64_t b) { return mul(a, b); }));
+    }
+
+private:
+    uint64_t n_ = 0;
+    uint64_t nInv_ = 0;
+    uint64_t r2_ = 0;
+    uint64_t one_ = 0;
+};
+
+// Арифметика по фиксированному модулю с выбранной реализацией умножения.
+// Для Montgomery модуль должен быть нечётным (модуль RSA, p и q); для
+// чётного модуля используется Int128.
+class ModArith {
+public:
+    explicit ModArith(uint64_t mod, MulModBackend backend = MulModBackend::Montgomery)
+        : mod_(mod), backend_(backend) {
+        if (mod == 0) {
+            throw std::invalid_argument("Модуль должен быть положительным");
+        }
+        if (backend_ == MulModBackend::BitSerial && mod > (uint64_t{1} << 63)) {
+            throw std::invalid_argument("Побитовое умножение поддерживает модуль до 2^63");
+        }
+        if (backend_ == MulModBackend::Montgomery) {
+            if (mod < 3 || (mod & 1) == 0) backend_ = MulModBackend::Int128;
+            else mont_ = Montgomery64(mod);
+        }
+    }
+
+    uint64_t modulus() const noexcept { return mod_; }
+    MulModBackend backend() const noexcept { return backend_; }
+
+    // (a * b) % mod для a, b в обычной форме. Одиночное произведение у
+    // Montgomery считается через 128 бит: перевод в форму Монтгомери и обратно
+    // (четыре REDC и два деления) дороже одного деления; выигрыш Монтгомери -
+    // только в цепочках умножений, как в pow().
+    uint64_t mul(uint64_t a, uint64_t b) const {
+        if (backend_ == MulModBackend::BitSerial) return mulModBitSerial(a, b, mod_);
+        return mulMod64(a, b, mod_);
+    }
+
+    // base^exp % mod; выбор реализации - один раз на всё возведение
+    uint64_t pow(uint64_t base, uint64_t exp) const {
+        if (mod_ == 1) return 0;
+        switch (backend_) {
+            case MulModBackend::BitSerial:
+                return modmul_detail::powWith(base % mod_, exp, 1, [this](uint64_t a, uint64_t b) {
+                    return mulModBitSerial(a, b, mod_);
+                });
+            case MulModBackend::Montgomery:
+                return mont_.pow(base, exp);
+            default:
+                return modmul_detail::powWith(base % mod_, exp, 1, [this](uint64_t a, uint64_t b) {
+                    return mulMod64(a, b, mod_);
+                });
+        }
+    }
+
+private:
+    uint64_t mod_;
+    MulModBackend backend_;
+    Montgomery64 mont_;
+};
+
+// base^exp mod mod для любого mod > 0 (Монтгомери для нечётного модуля)
+inline uint64_t powMod64(uint64_t base, uint64_t exp, uint64_t mod) {
+    return ModArith(mod).pow(base, exp);
+}
+
+#endif // MODMUL_H
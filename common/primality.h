@@ -0,0 +1,170 @@
+#ifndef PRIMALITY_H
+#define PRIMALITY_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "modmul.h"
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+// Детерминированная проверка простоты 64-битных чисел.
+//
+// Тест Миллера-Рабина с семью основаниями 2, 325, 9375, 28178, 450775,
+// 9780504, 1795265022 (набор Синклера) не ошибается ни на одном n < 2^64,
+// поэтому случайные основания и повторы не нужны. Возведение в степень -
+// умножением Монтгомери без деления (Montgomery64 из modmul.h);
+// константы модуля считаются один раз на число. Пакетная проверка ведёт
+// BATCH_LANES чисел одновременно: независимые цепочки умножений
+// перекрываются в конвейере процессора.
+
+namespace primality_detail {
+
+constexpr uint64_t BASES[] = {2, 325, 9375, 28178, 450775, 9780504, 1795265022};
+constexpr uint64_t SMALL_PRIMES[] = {2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37};
+constexpr size_t BATCH_LANES = 4;
+
+// Номер старшего единичного бита, x > 0
+inline int highestBit(uint64_t x) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long index;
+    _BitScanReverse64(&index, x);
+    return static_cast<int>(index);
+#else
+    return 63 - __builtin_clzll(x);
+#endif
+}
+
+// Результат пробного деления: 1 - простое, 0 - составное, -1 - нужен тест
+inline int trialDivision(uint64_t n) {
+    if (n < 2) return 0;
+    for (uint64_t p : SMALL_PRIMES) {
+        if (n % p == 0) return n == p ? 1 : 0;
+    }
+    return n < 37 * 37 ? 1 : -1;
+}
+
+} // namespace primality_detail
+
+// Детерминированная проверка простоты для любого n < 2^64
+inline bool isPrime64(uint64_t n) {
+    using namespace primality_detail;
+    const int trial = trialDivision(n);
+    if (trial >= 0) return trial == 1;
+
+    // n - 1 = d * 2^s, d нечётно
+    uint64_t d = n - 1;
+    int s = 0;
+    while ((d & 1) == 0) {
+        d >>= 1;
+        ++s;
+    }
+
+    const Montgomery64 m(n);
+    const uint64_t minusOne = n - m.one();  // n - 1 в форме Монтгомери
+    for (uint64_t a : BASES) {
+        if (a % n == 0) continue;
+        const uint64_t base = m.toMont(a);
+        uint64_t x = m.one();
+        for (int bit = highestBit(d); bit >= 0; --bit) {
+            x = m.mul(x, x);
+            if ((d >> bit) & 1) x = m.mul(x, base);
+        }
+        if (x == m.one() || x == minusOne) continue;
+        bool composite = true;
+        for (int i = 1; i < s && composite; ++i) {
+            x = m.mul(x, x);
+            composite = x != minusOne;
+        }
+        if (composite) return false;
+    }
+    return true;
+}
+
+// Пакетная проверка: out[i] = isPrime64(values[i])
+inline void isPrime64Batch(const uint64_t* values, size_t count, bool* out) {
+    using namespace primality_detail;
+
+    struct Lane {
+        Montgomery64 m;
+        uint64_t d;
+        uint64_t minusOne;
+        int s;
+        size_t index;
+    };
+    // Числа, не решённые пробным делением, собираются в группы по BATCH_LANES
+    Lane lanes[BATCH_LANES];
+    size_t active = 0;
+
+    auto runGroup = [&]() {
+        for (size_t j = 0; j < active; ++j) out[lanes[j].index] = true;
+        for (uint64_t a : BASES) {
+            uint64_t base[BATCH_LANES], x[BATCH_LANES];
+            int topBit = 0;
+            for (size_t j = 0; j < active; ++j) {
+                base[j] = lanes[j].m.toMont(a);
+                x[j] = lanes[j].m.one();
+                topBit = std::max(topBit, highestBit(lanes[j].d));
+            }
+            // Общий проход по битам: у более коротких d старшие биты нулевые,
+            // а квадрат единицы остаётся единицей
+            for (int bit = topBit; bit >= 0; --bit) {
+                for (size_t j = 0; j < active; ++j) {
+                    x[j] = lanes[j].m.mul(x[j], x[j]);
+                    if ((lanes[j].d >> bit) & 1) x[j] = lanes[j].m.mul(x[j], base[j]);
+                }
+            }
+            // Составные выбывают, оставшиеся сдвигаются к началу группы
+            size_t kept = 0;
+            for (size_t j = 0; j < active; ++j) {
+                const Lane& lane = lanes[j];
+                bool composite = false;
+                if (a % lane.m.modulus() != 0 && x[j] != lane.m.one() && x[j] != lane.minusOne) {
+                    composite = true;
+                    for (int i = 1; i < lane.s && composite; ++i) {
+                        x[j] = lane.m.mul(x[j], x[j]);
+                        composite = x[j] != lane.minusOne;
+                    }
+                }
+                if (composite) out[lane.index] = false;
+                else lanes[kept++] = lane;
+            }
+            active = kept;
+            if (active == 0) break;
+        }
+        active = 0;
+    };
+
+    for (size_t i = 0; i < count; ++i) {
+        const uint64_t n = values[i];
+        const int trial = trialDivision(n);
+        if (trial >= 0) {
+            out[i] = trial == 1;
+            continue;
+        }
+        Lane& lane = lanes[active++];
+        lane.m = Montgomery64(n);
+        lane.minusOne = n - lane.m.one();
+        lane.d = n - 1;
+        lane.s = 0;
+        while ((lane.d & 1) == 0) {
+            lane.d >>= 1;
+            ++lane.s;
+        }
+        lane.index = i;
+        if (active == BATCH_LANES) runGroup();
+    }
+    if (active > 0) runGroup();
+}
+
+inline std::vector<bool> isPrime64Batch(const std::vector<uint64_t>& values) {
+    std::unique_ptr<bool[]> flags(new bool[values.size()]);
+    isPrime64Batch(values.data(), values.size(), flags.get());
+    return std::vector<bool>(flags.get(), flags.get() + values.size());
+}
+
+#endif // PRIMALITY_H
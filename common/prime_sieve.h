@@ -0,0 +1,123 @@
+#ifndef PRIME_SIEVE_H
+#define PRIME_SIEVE_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <vector>
+#include "primality.h"
+
+// Поиск простых чисел с инкрементным решетом кандидатов.
+//
+// Для случайного нечётного старта x остатки x mod p считаются один раз по
+// первым нечётным простым; шаг x += 2 обновляет их сложением и одним
+// условным вычитанием (цикл без ветвлений векторизуется компилятором).
+// Тест простоты запускается только для кандидатов, у которых ни один
+// остаток не равен нулю: решето из 8192 простых отсеивает ~90% нечётных
+// чисел. Остатки для длинных чисел вычисляются функцией вызывающего кода,
+// поэтому одно решето обслуживает и uint64_t, и BigInt.
+
+namespace prime_sieve_detail {
+
+constexpr size_t SIEVE_PRIME_COUNT = 8192;
+// Для 64-битных чисел тест Миллера-Рабина дешёвый, и выгодно решето
+// поменьше: начальные остатки считаются делением на каждое простое
+constexpr size_t SIEVE_PRIME_COUNT_64 = 16;
+
+// Первые SIEVE_PRIME_COUNT нечётных простых (3, 5, 7, ..., 84047)
+inline const std::vector<int32_t>& sievePrimes() {
+    static const std::vector<int32_t> primes = [] {
+        const int32_t limit = 90000;
+        std::vector<bool> composite(limit + 1, false);
+        std::vector<int32_t> result;
+        for (int32_t i = 3; i <= limit && result.size() < SIEVE_PRIME_COUNT; i += 2) {
+            if (composite[i]) continue;
+            result.push_back(i);
+            for (int64_t j = int64_t{i} * i; j <= limit; j += 2 * i) composite[j] = true;
+        }
+        return result;
+    }();
+    return primes;
+}
+
+} // namespace prime_sieve_detail
+
+// Остатки нечётного кандидата по первым count нечётным простым.
+// Простые решета должны быть меньше кандидатов: нулевой остаток означает
+// составное число (см. sievePrimesBelow).
+class CandidateSieve {
+public:
+    explicit CandidateSieve(size_t count = prime_sieve_detail::SIEVE_PRIME_COUNT)
+        : primes_(prime_sieve_detail::sievePrimes().data()),
+          count_(std::min(count, prime_sieve_detail::sievePrimes().size())),
+          residues_(count_) {}
+
+    size_t size() const noexcept { return count_; }
+
+    // Новый старт x: residueOf(p) возвращает x mod p. true - x прошёл решето
+    template <typename ResidueOf>
+    bool reset(ResidueOf residueOf) {
+        int32_t zero = 0;
+        for (size_t i = 0; i < count_; ++i) {
+            residues_[i] = static_cast<int32_t>(residueOf(static_cast<uint32_t>(primes_[i])));
+            zero |= residues_[i] == 0;
+        }
+        return zero == 0;
+    }
+
+    // x += 2. true - новый x прошёл решето
+    bool step() {
+        int32_t* r = residues_.data();
+        int32_t zero = 0;
+        for (size_t i = 0; i < count_; ++i) {
+            int32_t v = r[i] + 2;
+            v -= primes_[i] & -static_cast<int32_t>(v >= primes_[i]);
+            r[i] = v;
+            zero |= v == 0;
+        }
+        return zero == 0;
+    }
+
+private:
+    const int32_t* primes_;
+    size_t count_;
+    std::vector<int32_t> residues_;
+};
+
+// Число простых решета, меньших bound (не больше limit)
+inline size_t sievePrimesBelow(uint64_t bound, size_t limit) {
+    const auto& primes = prime_sieve_detail::sievePrimes();
+    const size_t below = static_cast<size_t>(
+        std::lower_bound(primes.begin(), primes.end(), static_cast<int64_t>(std::min<uint64_t>(bound, INT32_MAX)),
+                         [](int32_t p, int64_t b) { return p < b; }) -
+        primes.begin());
+    return std::min(below, limit);
+}
+
+// Случайное простое из [min, max] для min >= 3: от случайного нечётного
+// старта кандидаты идут с шагом 2 до первого простого; при выходе за max
+// выбирается новый старт (диапазон должен содержать простое). Простые
+// после длинных промежутков выпадают чаще, как и у любой генерации
+// "следующего простого".
+inline uint64_t randomPrime64(std::mt19937_64& gen, uint64_t min, uint64_t max) {
+    if (min < 3 || max < min || (min | 1) > max) {
+        throw std::invalid_argument("Диапазон простых должен быть непустым и начинаться не ниже 3");
+    }
+    std::uniform_int_distribution<uint64_t> dist(min, max);
+    CandidateSieve sieve(sievePrimesBelow(min, prime_sieve_detail::SIEVE_PRIME_COUNT_64));
+    while (true) {
+        uint64_t x = dist(gen) | 1;
+        if (x > max) continue;
+        bool survives = sieve.reset([x](uint32_t p) { return x % p; });
+        while (true) {
+            if (survives && isPrime64(x)) return x;
+            if (max - x < 2) break;
+            x += 2;
+            survives = sieve.step();
+        }
+    }
+}
+
+#endif // PRIME_SIEVE_H
@@ -0,0 +1,236 @@
+#ifndef STREAM_CIPHER_H
+#define STREAM_CIPHER_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "chunk_pipeline.h"
+
+// Общий интерфейс потокового шифрования файлов для всех шифров репозитория.
+//
+// BlockTransform - преобразование потока кусками фиксированного размера:
+// process(offset, in, size, out) обрабатывает кусок, начинающийся с байта
+// offset входного потока. Куски с независимым результатом (CTR, ECB,
+// контейнер RSA/LUC) обрабатываются параллельно копиями преобразования;
+// куски, зависящие от предыдущих (шифрование CFB), - по порядку одним
+// экземпляром, но чтение и запись всё равно идут в своих потоках.
+// Преобразованию, которому нужен конец предыдущего куска (расшифрование
+// CFB), драйвер кладёт historySize() байт входа прямо перед in.
+//
+// StreamCipher - шифр с форматом файла: пишет или читает заголовок
+// (контейнер, IV, счётчик) и выдаёт BlockTransform для данных.
+//
+// runBlockTransform - единственный драйвер: поток чтения, обработчики
+// (chunk_pipeline.h) и запись по порядку; вывод от числа потоков не зависит.
+
+// Размер оставшейся части потока
+inline uint64_t remainingStreamSize(std::istream& in) {
+    const auto pos = in.tellg();
+    in.seekg(0, std::ios::end);
+    const auto end = in.tellg();
+    in.seekg(pos);
+    if (pos < 0 || end < pos) {
+        throw std::runtime_error("Не удалось определить размер входного файла");
+    }
+    return static_cast<uint64_t>(end - pos);
+}
+
+// Размер входа неизвестен: поток не поддерживает позиционирование (канал, stdin)
+constexpr uint64_t UNKNOWN_STREAM_SIZE = UINT64_MAX;
+
+// Размер оставшейся части потока или UNKNOWN_STREAM_SIZE; позиция и
+// состояние потока не меняются
+inline uint64_t remainingStreamSizeOrUnknown(std::istream& in) {
+    const auto pos = in.tellg();
+    if (pos < 0) return UNKNOWN_STREAM_SIZE;
+    const auto state = in.rdstate();
+    const auto end = in.seekg(0, std::ios::end).tellg();
+    in.clear();
+    in.seekg(pos);
+    in.clear(state);
+    return end >= pos ? static_cast<uint64_t>(end - pos) : UNKNOWN_STREAM_SIZE;
+}
+
+class BlockTransform {
+public:
+    virtual ~BlockTransform() = default;
+
+    // Байт входа в куске; все куски, кроме последнего, полные
+    virtual size_t chunkSize() const = 0;
+    // Наибольший выход для куска из size байт входа
+    virtual size_t maxOutputSize(size_t size) const = 0;
+    // Байт предыдущего входа, доступных перед in при offset > 0 (не больше chunkSize())
+    virtual size_t historySize() const { return 0; }
+
+    // Кусок входа [offset, offset + size) -> out; возвращает длину выхода
+    virtual size_t process(uint64_t offset, const uint8_t* in, size_t size, uint8_t* out) = 0;
+
+    // false - результат куска зависит от предыдущих, и все куски по порядку
+    // обрабатывает этот экземпляр; clone() тогда не вызывается
+    virtual bool independentChunks() const { return true; }
+    // Независимая копия для другого потока обработки
+    virtual std::unique_ptr<BlockTransform> clone() const = 0;
+
+    // После всех кусков: inputSize - сколько байт входа прочитано
+    virtual void finish(uint64_t inputSize) { (void)inputSize; }
+};
+
+class StreamCipher {
+public:
+    virtual ~StreamCipher() = default;
+
+    virtual const char* name() const = 0;
+    // Пишет заголовок шифртекста и возвращает преобразование открытого текста.
+    // plainSize == UNKNOWN_STREAM_SIZE для входа без позиционирования; шифр,
+    // которому длина нужна в заголовке, тогда отказывает (runtime_error)
+    virtual std::unique_ptr<BlockTransform> encryptor(std::ostream& out, uint64_t plainSize) = 0;
+    // Читает заголовок шифртекста и возвращает преобразование данных после него
+    virtual std::unique_ptr<BlockTransform> decryptor(std::istream& in) = 0;
+};
+
+// Прогоняет остаток потока in через transform в out. threads == 0 - все ядра
+inline void runBlockTransform(std::istream& in, std::ostream& out, BlockTransform& transform,
+                              unsigned threads = 0) {
+    threads = pipelineThreads(threads);
+    const size_t chunk = transform.chunkSize();
+    const size_t history = transform.historySize();
+    const size_t outCapacity = transform.maxOutputSize(chunk);
+    if (chunk == 0 || history > chunk) {
+        throw std::invalid_argument("Некорректный размер куска преобразования");
+    }
+
+    // Буферы не больше входа: малый файл не платит за выделение полного куска
+    const uint64_t expected = remainingStreamSizeOrUnknown(in);
+
+    // Чтение: [history байт конца предыдущего куска][кусок]
+    std::vector<uint8_t> tail;
+    uint64_t inputSize = 0;
+    bool inputEnded = false;
+    auto read = [&](PipelineBuffer& buffer) {
+        if (inputEnded) return false;
+        // Размер потока - только подсказка, читается до фактического конца
+        const size_t want = static_cast<size_t>(
+            std::min<uint64_t>(chunk, std::max<uint64_t>(expected - std::min(expected, inputSize), 1)));
+        buffer.data.resize(history + want);
+        std::copy(tail.begin(), tail.end(), buffer.data.begin());
+        in.read(reinterpret_cast<char*>(buffer.data.data() + history), static_cast<std::streamsize>(want));
+        buffer.size = static_cast<size_t>(in.gcount());
+        if (buffer.size == want && want < chunk && in.peek() != std::char_traits<char>::eof()) {
+            // Поток длиннее ожидаемого: дочитываем полный кусок
+            buffer.data.resize(history + chunk);
+            in.read(reinterpret_cast<char*>(buffer.data.data() + history + want),
+                    static_cast<std::streamsize>(chunk - want));
+            buffer.size += static_cast<size_t>(in.gcount());
+        }
+        if (in.bad()) {
+            throw std::runtime_error("Ошибка чтения входного файла");
+        }
+        inputEnded = buffer.size < chunk;
+        if (buffer.size == 0) return false;
+        inputSize += buffer.size;
+        if (history > 0) {
+            tail.assign(buffer.data.begin() + static_cast<std::ptrdiff_t>(buffer.size),
+                        buffer.data.begin() + static_cast<std::ptrdiff_t>(buffer.size + history));
+        }
+        return true;
+    };
+
+    auto makeWorkerFor = [&](BlockTransform* shared) {
+        return [&, shared] {
+            std::shared_ptr<BlockTransform> own;
+            if (!shared) own = transform.clone();
+            BlockTransform* target = shared ? shared : own.get();
+            return [&, own, target](uint64_t index, const PipelineBuffer& input, PipelineBuffer& output) {
+                output.data.resize(input.size == chunk ? outCapacity : target->maxOutputSize(input.size));
+                output.size = target->process(index * chunk, input.data.data() + history, input.size,
+                                              output.data.data());
+            };
+        };
+    };
+    auto write = [&](const PipelineBuffer& output) {
+        out.write(reinterpret_cast<const char*>(output.data.data()), static_cast<std::streamsize>(output.size));
+    };
+
+    // Вход в один кусок: параллелить нечего, потоки не запускаются
+    if (threads == 1 || expected <= chunk) {
+        runChunkPipeline(1, read, makeWorkerFor(&transform), write);
+    } else if (!transform.independentChunks()) {
+        runChunkPipelineThreaded(1, read, makeWorkerFor(&transform), write);
+    } else {
+        runChunkPipelineThreaded(threads, read, makeWorkerFor(nullptr), write);
+    }
+
+    // Буфер потока сбрасывается здесь: ошибка записи последних данных
+    // (например, диск заполнен) видна только после flush
+    if (!out.flush()) {
+        throw std::runtime_error("Ошибка записи выходного файла");
+    }
+    transform.finish(inputSize);
+}
+
+inline void encryptStream(std::istream& in, std::ostream& out, StreamCipher& cipher, unsigned threads = 0) {
+    const std::unique_ptr<BlockTransform> transform = cipher.encryptor(out, remainingStreamSizeOrUnknown(in));
+    runBlockTransform(in, out, *transform, threads);
+}
+
+inline void decryptStream(std::istream& in, std::ostream& out, StreamCipher& cipher, unsigned threads = 0) {
+    const std::unique_ptr<BlockTransform> transform = cipher.decryptor(in);
+    runBlockTransform(in, out, *transform, threads);
+}
+
+namespace stream_cipher_detail {
+
+// Открывает файлы и вызывает run(in, out). При любой ошибке недописанный
+// выходной файл удаляется, чтобы обрезанный результат не приняли за готовый;
+// устройства и каналы (/dev/stdout, FIFO) не удаляются.
+template <typename Run>
+void withFiles(const std::string& inputFile, const std::string& outputFile, Run run) {
+    std::ifstream in(inputFile, std::ios::binary);
+    if (!in) {
+        throw std::runtime_error("Не удалось открыть входной файл: " + inputFile);
+    }
+    std::ofstream out(outputFile, std::ios::binary);
+    if (!out) {
+        throw std::runtime_error("Не удалось создать выходной файл: " + outputFile);
+    }
+    try {
+        run(in, out);
+        out.close();
+        if (!out) {
+            throw std::runtime_error("Ошибка записи выходного файла: " + outputFile);
+        }
+    } catch (...) {
+        out.close();
+        std::error_code error;
+        if (std::filesystem::is_regular_file(outputFile, error)) {
+            std::filesystem::remove(outputFile, error);
+        }
+        throw;
+    }
+}
+
+} // namespace stream_cipher_detail
+
+inline void encryptFileStream(const std::string& inputFile, const std::string& outputFile, StreamCipher& cipher,
+                              unsigned threads = 0) {
+    stream_cipher_detail::withFiles(inputFile, outputFile, [&](std::istream& in, std::ostream& out) {
+        encryptStream(in, out, cipher, threads);
+    });
+}
+
+inline void decryptFileStream(const std::string& inputFile, const std::string& outputFile, StreamCipher& cipher,
+                              unsigned threads = 0) {
+    stream_cipher_detail::withFiles(inputFile, outputFile, [&](std::istream& in, std::ostream& out) {
+        decryptStream(in, out, cipher, threads);
+    });
+}
+
+#endif // STREAM_CIPHER_H
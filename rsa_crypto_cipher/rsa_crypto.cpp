@@ -7,29 +7,36 @@
  * 3. Шифрование и дешифрование бинарных файлов
  * 
  * Основные компоненты:
- * - Тест Миллера-Рабина для проверки простых чисел
+ * - Детерминированный тест Миллера-Рабина (7 оснований) для проверки простых чисел
  * - Модульные операции для работы с большими числами
  * - Генерация простых чисел в заданном диапазоне
  * - Вычисление модульной инверсии (расширенный алгоритм Евклида)
  * 
  * Функционал:
- * 1. mulmod() - Безопасное умножение по модулю
+ * 1. mulmod() - Умножение по модулю через 128-битное произведение
  * 2. powmod() - Возведение в степень по модулю
- * 3. isPrime() - Проверка числа на простоту
- * 4. generatePrime() - Генерация простого числа
+ * 3. isPrime64() - Проверка простоты (common/primality.h)
+ * 4. generatePrime() - Генерация простого числа (инкрементное решето)
  * 5. generateRSAKeys() - Создание ключей RSA
  * 6. encryptMessage()/decryptMessage() - Работа с текстом
  * 7. encryptFile()/decryptFile() - Работа с файлами
+ * 8. decryptCRT() - Расшифрование через китайскую теорему об остатках (формула Гарнера)
+ * 9. encryptMessageBlocks()/decryptMessageBlocks() - Блочный режим для текста
+ * 10. compareMulModBackends() - Сравнение реализаций умножения (побитовое,
+ *     128-битное, Монтгомери) на шифровании файла
  * 
  * Особенности:
  * - Использование длинной арифметики для предотвращения переполнений
- * - Побайтовое шифрование данных
+ * - Блочное шифрование (несколько байт на блок) текста и файлов; файлы
+ *   записываются в двоичный контейнер со словами фиксированной длины
+ * - Многопоточное шифрование файлов кусками с сохранением порядка
+ * - Файловые команды умножают по модулю методом Монтгомери: константы
+ *   (R^2 mod n, mod p, mod q) вычисляются один раз на ключ (common/modmul.h)
  * - Автоматическая генерация ключей
  * - Консольный интерфейс с меню выбора операций
  * 
  * Ограничения:
  * - Работает с числами до 20 разрядов (int64_t)
- * - Шифрование файлов выполняется побайтово (не для больших файлов)
  * 
  * Использование:
  * Программа предлагает интерактивное меню для выбора операций:
@@ -38,12 +45,13 @@
  * 3. Шифрование файла
  * 4. Дешифрование файла
  * 5. Генерация новых ключей
+ * 6. Сравнение реализаций умножения на файле (по умолчанию 100 МБ)
  * 
  * Компиляция с помощью g++:
- * g++ -std=c++17 rsa_crypto.cpp -o rsa_crypto
+ * g++ -std=c++17 -pthread -I../common rsa_crypto.cpp -o rsa_crypto
  * 
  * Для оптимизации и предупреждений можно использовать:
- * g++ -std=c++11 -Wall -Wextra -Wpedantic -O2 -o rsa_crypto rsa_crypto.cpp
+ * g++ -std=c++17 -Wall -Wextra -Wpedantic -O2 -pthread -I../common -o rsa_crypto rsa_crypto.cpp
  * 
  * Пример вызова:
  * ./rsa_crypto
@@ -69,88 +77,34 @@
 #include <algorithm>
 #include <numeric>
 #include <stdexcept>
+#include <chrono>
+#include <filesystem>
+#include <iomanip>
+#include "block_codec.h"
+#include "cipher_container.h"
+#include "modmul.h"
+#include "prime_sieve.h"
 
 using namespace std;
 
-// Функция для модульного умножения (a * b) % mod, избегая переполнения
+// Функция для модульного умножения (a * b) % mod без переполнения
 int64_t mulmod(int64_t a, int64_t b, int64_t mod) {
-    int64_t res = 0;
-    a = a % mod;
-    while (b > 0) {
-        if (b % 2 == 1)
-            res = (res + a) % mod;
-        a = (a * 2) % mod;
-        b = b / 2;
-    }
-    return res % mod;
+    return static_cast<int64_t>(mulMod64(static_cast<uint64_t>(a), static_cast<uint64_t>(b),
+                                         static_cast<uint64_t>(mod)));
 }
 
 // Функция для возведения в степень по модулю (a^b) % mod
 int64_t powmod(int64_t a, int64_t b, int64_t mod) {
-    int64_t res = 1;
-    a = a % mod;
-    while (b > 0) {
-        if (b % 2 == 1)
-            res = mulmod(res, a, mod);
-        a = mulmod(a, a, mod);
-        b = b >> 1;
-    }
-    return res;
+    return static_cast<int64_t>(powMod64(static_cast<uint64_t>(a), static_cast<uint64_t>(b),
+                                         static_cast<uint64_t>(mod)));
 }
 
-// Тест Миллера-Рабина для проверки простоты
-bool millerTest(int64_t d, int64_t n) {
-    random_device rd;
-    mt19937_64 gen(rd());
-    uniform_int_distribution<int64_t> dist(2, n - 2);
-    
-    int64_t a = dist(gen);
-    int64_t x = powmod(a, d, n);
-    
-    if (x == 1 || x == n - 1)
-        return true;
-    
-    while (d != n - 1) {
-        x = mulmod(x, x, n);
-        d *= 2;
-        
-        if (x == 1) return false;
-        if (x == n - 1) return true;
-    }
-    
-    return false;
-}
-
-// Функция для проверки, является ли число простым (используя тест Миллера-Рабина)
-bool isPrime(int64_t n, int k = 5) {
-    if (n <= 1 || n == 4) return false;
-    if (n <= 3) return true;
-    
-    int64_t d = n - 1;
-    while (d % 2 == 0)
-        d /= 2;
-    
-    for (int i = 0; i < k; i++)
-        if (!millerTest(d, n))
-            return false;
-    
-    return true;
-}
-
-// Функция для генерации простого числа в заданном диапазоне
+// Случайное простое в заданном диапазоне: инкрементное решето кандидатов
+// и тест Миллера-Рабина только для прошедших его (common/prime_sieve.h)
 int64_t generatePrime(int64_t min, int64_t max) {
-    random_device rd;
-    mt19937_64 gen(rd());
-    uniform_int_distribution<int64_t> dist(min, max);
-    
-    int64_t num;
-    do {
-        num = dist(gen);
-        if (num % 2 == 0 && num != 2) 
-            num++;
-    } while (!isPrime(num));
-    
-    return num;
+    // Генератор инициализируется один раз, а не на каждый вызов
+    static mt19937_64 gen(random_device{}());
+    return static_cast<int64_t>(randomPrime64(gen, static_cast<uint64_t>(min), static_cast<uint64_t>(max)));
 }
 
 // Функция для вычисления НОД (алгоритм Евклида)
@@ -194,6 +148,13 @@ struct RSAKeys {
     int64_t publicKey;
     int64_t privateKey;
     int64_t n;
+
+    // Параметры CRT для закрытого ключа
+    int64_t p;
+    int64_t q;
+    int64_t dP;    // d mod (p - 1)
+    int64_t dQ;    // d mod (q - 1)
+    int64_t qInv;  // q^-1 mod p
 };
 
 // Генерация ключей RSA
@@ -225,9 +186,47 @@ RSAKeys generateRSAKeys() {
     // Вычисляем секретную экспоненту
     keys.privateKey = modInverse(e, phi);
     
+    // Параметры CRT для ускоренного расшифрования
+    keys.p = p;
+    keys.q = q;
+    keys.dP = keys.privateKey % (p - 1);
+    keys.dQ = keys.privateKey % (q - 1);
+    keys.qInv = modInverse(q % p, p);
+    
     return keys;
 }
 
+// Расшифрование одного числа через CRT: две экспоненты половинной длины
+// по модулям p и q, объединяемые формулой Гарнера
+int64_t decryptCRT(int64_t c, const RSAKeys& keys) {
+    int64_t m1 = powmod(c % keys.p, keys.dP, keys.p);
+    int64_t m2 = powmod(c % keys.q, keys.dQ, keys.q);
+    int64_t h = mulmod(keys.qInv, (m1 - m2 % keys.p + keys.p) % keys.p, keys.p);
+    return m2 + h * keys.q;
+}
+
+// Арифметика по модулям ключа для файловых команд: при выборе Montgomery
+// константы R^2 mod n, mod p и mod q вычисляются один раз, а не на каждый блок
+struct RSAArithmetic {
+    ModArith n;
+    ModArith p;
+    ModArith q;
+
+    RSAArithmetic(const RSAKeys& keys, MulModBackend backend)
+        : n(static_cast<uint64_t>(keys.n), backend),
+          p(static_cast<uint64_t>(keys.p), backend),
+          q(static_cast<uint64_t>(keys.q), backend) {}
+};
+
+// decryptCRT с заранее подготовленными модулями ключа
+uint64_t decryptCRT(uint64_t c, const RSAKeys& keys, const RSAArithmetic& arith) {
+    const uint64_t p = static_cast<uint64_t>(keys.p);
+    const uint64_t m1 = arith.p.pow(c, static_cast<uint64_t>(keys.dP));
+    const uint64_t m2 = arith.q.pow(c, static_cast<uint64_t>(keys.dQ));
+    const uint64_t h = arith.p.mul(static_cast<uint64_t>(keys.qInv), (m1 + p - m2 % p) % p);
+    return m2 + h * static_cast<uint64_t>(keys.q);
+}
+
 // Шифрование сообщения
 vector<int64_t> encryptMessage(const string& message, int64_t e, int64_t n) {
     vector<int64_t> encrypted;
@@ -252,32 +251,81 @@ string decryptMessage(const vector<int64_t>& encrypted, int64_t d, int64_t n) {
     return decrypted;
 }
 
-// Шифрование файла
-void encryptFile(const string& inputFile, const string& outputFile, int64_t e, int64_t n) {
+// Дешифрование сообщения закрытым ключом через CRT
+string decryptMessage(const vector<int64_t>& encrypted, const RSAKeys& keys) {
+    string decrypted;
+    
+    for (int64_t num : encrypted) {
+        decrypted += static_cast<char>(decryptCRT(num, keys));
+    }
+    
+    return decrypted;
+}
+
+// Блочное шифрование: в блок упаковывается столько байт, сколько позволяет
+// модуль, сообщение дополняется по PKCS#7 (см. common/block_codec.h)
+vector<int64_t> encryptMessageBlocks(const string& message, int64_t e, int64_t n) {
+    const size_t k = blockBytesForModulus(static_cast<uint64_t>(n));
+    if (k == 0) {
+        throw invalid_argument("Модуль слишком мал для блочного режима");
+    }
+    
+    vector<int64_t> encrypted;
+    encrypted.reserve(paddedSize(message.size(), k) / k);
+    forEachPaddedBlock(message, k, [&](uint64_t m) {
+        encrypted.push_back(powmod(static_cast<int64_t>(m), e, n));
+    });
+    
+    return encrypted;
+}
+
+// Блочное дешифрование закрытым ключом через CRT
+string decryptMessageBlocks(const vector<int64_t>& encrypted, const RSAKeys& keys) {
+    const size_t k = blockBytesForModulus(static_cast<uint64_t>(keys.n));
+    if (k == 0) {
+        throw invalid_argument("Модуль слишком мал для блочного режима");
+    }
+    
+    string decrypted(encrypted.size() * k, '\0');
+    auto* out = reinterpret_cast<uint8_t*>(&decrypted[0]);
+    for (size_t i = 0; i < encrypted.size(); ++i) {
+        unpackBlock(static_cast<uint64_t>(decryptCRT(encrypted[i], keys)), k, out + i * k);
+    }
+    stripPadding(decrypted, k);
+    
+    return decrypted;
+}
+
+// Шифрование файла в двоичный контейнер (см. common/cipher_container.h):
+// блоки по размеру модуля, слова шифртекста фиксированной длины.
+// Куски файла шифруются в threads потоках (0 - все ядра), порядок сохраняется;
+// backend - реализация умножения по модулю
+void encryptFile(const string& inputFile, const string& outputFile, int64_t e, int64_t n,
+                 unsigned threads = 0, MulModBackend backend = MulModBackend::Montgomery) {
     ifstream in(inputFile, ios::binary);
     if (!in) {
         throw runtime_error("Не удалось открыть входной файл: " + inputFile);
     }
     
-    ofstream out(outputFile);
+    ofstream out(outputFile, ios::binary);
     if (!out) {
         throw runtime_error("Не удалось создать выходной файл: " + outputFile);
     }
     
-    char c;
-    while (in.get(c)) {
-        int64_t m = static_cast<int64_t>(static_cast<unsigned char>(c));
-        int64_t encrypted = powmod(m, e, n);
-        out << encrypted << " ";
-    }
-    
-    in.close();
-    out.close();
+    const ContainerHeader header = makeContainerHeader(
+        ContainerAlgorithm::RSA, static_cast<uint64_t>(n),
+        blockBytesForModulus(static_cast<uint64_t>(n)), remainingStreamSize(in));
+    const ModArith arith(static_cast<uint64_t>(n), backend);
+    const auto transform = [e, arith](uint64_t m) {
+        return arith.pow(m, static_cast<uint64_t>(e));
+    };
+    encryptContainer(in, out, header, [&] { return transform; }, threads);
 }
 
 // Дешифрование файла
-void decryptFile(const string& inputFile, const string& outputFile, int64_t d, int64_t n) {
-    ifstream in(inputFile);
+void decryptFile(const string& inputFile, const string& outputFile, int64_t d, int64_t n,
+                 unsigned threads = 0, MulModBackend backend = MulModBackend::Montgomery) {
+    ifstream in(inputFile, ios::binary);
     if (!in) {
         throw runtime_error("Не удалось открыть входной файл: " + inputFile);
     }
@@ -287,14 +335,103 @@ void decryptFile(const string& inputFile, const string& outputFile, int64_t d, i
         throw runtime_error("Не удалось создать выходной файл: " + outputFile);
     }
     
-    int64_t num;
-    while (in >> num) {
-        int64_t decrypted = powmod(num, d, n);
-        out << static_cast<char>(decrypted);
+    const ContainerHeader header = readContainerHeader(in, ContainerAlgorithm::RSA);
+    const ModArith arith(static_cast<uint64_t>(n), backend);
+    const auto transform = [d, arith](uint64_t c) {
+        return arith.pow(c, static_cast<uint64_t>(d));
+    };
+    decryptContainer(in, out, header, [&] { return transform; }, threads);
+}
+
+// Дешифрование файла закрытым ключом через CRT
+void decryptFile(const string& inputFile, const string& outputFile, const RSAKeys& keys,
+                 unsigned threads = 0, MulModBackend backend = MulModBackend::Montgomery) {
+    ifstream in(inputFile, ios::binary);
+    if (!in) {
+        throw runtime_error("Не удалось открыть входной файл: " + inputFile);
+    }
+    
+    ofstream out(outputFile, ios::binary);
+    if (!out) {
+        throw runtime_error("Не удалось создать выходной файл: " + outputFile);
     }
     
-    in.close();
-    out.close();
+    const ContainerHeader header = readContainerHeader(in, ContainerAlgorithm::RSA);
+    const RSAArithmetic arith(keys, backend);
+    const auto transform = [&keys, &arith](uint64_t c) {
+        return decryptCRT(c, keys, arith);
+    };
+    decryptContainer(in, out, header, [&] { return transform; }, threads);
+}
+
+// Совпадают ли два файла побайтно
+bool sameContents(const string& a, const string& b) {
+    ifstream fa(a, ios::binary), fb(b, ios::binary);
+    vector<char> ba(1 << 20), bb(1 << 20);
+    while (fa && fb) {
+        fa.read(ba.data(), static_cast<streamsize>(ba.size()));
+        fb.read(bb.data(), static_cast<streamsize>(bb.size()));
+        if (fa.gcount() != fb.gcount() || !equal(ba.begin(), ba.begin() + fa.gcount(), bb.begin())) {
+            return false;
+        }
+    }
+    return fa.eof() && fb.eof();
+}
+
+// Сравнение реализаций умножения на файловых командах: шифрование и
+// расшифрование (CRT) одного файла каждым способом, МБ/с и ускорение
+// относительно побитового умножения. Пустое имя - случайный файл size байт
+void compareMulModBackends(string inputFile, const RSAKeys& keys, size_t size = size_t{100} << 20,
+                           unsigned threads = 0) {
+    namespace fs = std::filesystem;
+    const fs::path dir = fs::temp_directory_path();
+    const string encrypted = (dir / "rsa_mulmod_compare.enc").string();
+    const string decrypted = (dir / "rsa_mulmod_compare.dec").string();
+    string generated;
+    if (inputFile.empty()) {
+        generated = (dir / "rsa_mulmod_compare.bin").string();
+        ofstream out(generated, ios::binary);
+        mt19937_64 gen(2025);
+        vector<uint64_t> chunk(1 << 17);
+        for (size_t written = 0; written < size; written += chunk.size() * 8) {
+            for (auto& w : chunk) w = gen();
+            out.write(reinterpret_cast<const char*>(chunk.data()),
+                      static_cast<streamsize>(min(chunk.size() * 8, size - written)));
+        }
+        if (!out) {
+            throw runtime_error("Не удалось создать файл: " + generated);
+        }
+        inputFile = generated;
+    }
+    const double megabytes = static_cast<double>(fs::file_size(inputFile)) / (1 << 20);
+    cout << "Файл " << inputFile << ", " << fixed << setprecision(1) << megabytes << " МБ\n";
+
+    double baseline[2] = {0, 0};
+    for (MulModBackend backend : {MulModBackend::BitSerial, MulModBackend::Int128, MulModBackend::Montgomery}) {
+        const auto t0 = chrono::steady_clock::now();
+        encryptFile(inputFile, encrypted, keys.publicKey, keys.n, threads, backend);
+        const auto t1 = chrono::steady_clock::now();
+        decryptFile(encrypted, decrypted, keys, threads, backend);
+        const auto t2 = chrono::steady_clock::now();
+        if (!sameContents(inputFile, decrypted)) {
+            throw runtime_error(string("Расшифрованный файл не совпадает с исходным: ") + mulModBackendName(backend));
+        }
+
+        const double seconds[2] = {chrono::duration<double>(t1 - t0).count(),
+                                   chrono::duration<double>(t2 - t1).count()};
+        if (backend == MulModBackend::BitSerial) {
+            baseline[0] = seconds[0];
+            baseline[1] = seconds[1];
+        }
+        cout << "  " << left << setw(11) << mulModBackendName(backend) << right << setprecision(2)
+             << " шифрование " << setw(8) << megabytes / seconds[0] << " МБ/с (x" << baseline[0] / seconds[0]
+             << "), расшифрование " << setw(8) << megabytes / seconds[1] << " МБ/с (x"
+             << baseline[1] / seconds[1] << ")\n";
+    }
+
+    fs::remove(encrypted);
+    fs::remove(decrypted);
+    if (!generated.empty()) fs::remove(generated);
 }
 
 int main() {
@@ -306,6 +443,7 @@ int main() {
     cout << "3. Шифровать файл\n";
     cout << "4. Дешифровать файл\n";
     cout << "5. Сгенерировать новые ключи\n";
+    cout << "6. Сравнить реализации умножения по модулю на файле\n";
     cout << "Выберите действие: ";
     
     int choice;
@@ -333,7 +471,7 @@ int main() {
                 string message;
                 getline(cin, message);
                 
-                vector<int64_t> encrypted = encryptMessage(message, keys.publicKey, keys.n);
+                vector<int64_t> encrypted = encryptMessageBlocks(message, keys.publicKey, keys.n);
                 cout << "Зашифрованное сообщение: ";
                 for (int64_t num : encrypted) {
                     cout << num << " ";
@@ -359,7 +497,7 @@ int main() {
                     pos = spacePos + 1;
                 }
                 
-                string decrypted = decryptMessage(encrypted, keys.privateKey, keys.n);
+                string decrypted = decryptMessageBlocks(encrypted, keys);
                 cout << "Расшифрованное сообщение: " << decrypted << endl;
                 break;
             }
@@ -385,10 +523,18 @@ int main() {
                 string outputFile;
                 getline(cin, outputFile);
                 
-                decryptFile(inputFile, outputFile, keys.privateKey, keys.n);
+                decryptFile(inputFile, outputFile, keys);
                 cout << "Файл успешно расшифрован." << endl;
                 break;
             }
+            case 6: {
+                cout << "Введите имя файла (пусто - случайные данные 100 МБ): ";
+                string inputFile;
+                getline(cin, inputFile);
+                
+                compareMulModBackends(inputFile, keys);
+                break;
+            }
             default:
                 cout << "Неверный выбор." << endl;
         }